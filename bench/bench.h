@@ -0,0 +1,224 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "scanner.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+* Shared helpers of the benchmarks: a deterministic input generator, temporary input files and a best-of-n timer. Every benchmark
+* generates its inputs itself, so its results only depend on the machine it runs on.
+**/
+
+const int BENCH_RUNS = 5;
+
+/*
+ * xorshift64, seeded by the caller, so every run generates the same input.
+ */
+class BenchRandom {
+private:
+	std::uint64_t state;
+
+public:
+	explicit BenchRandom(std::uint64_t seed) : state(seed) {}
+
+	std::uint64_t next() {
+		this->state ^= this->state << 13;
+		this->state ^= this->state >> 7;
+		this->state ^= this->state << 17;
+		return this->state;
+	}
+
+	std::size_t below(std::size_t bound) {
+		return this->next() % bound;
+	}
+};
+
+inline void append_identifier(std::string* text, BenchRandom* random, std::size_t distinct) {
+	std::size_t index = random->below(distinct);
+
+	text->push_back('a' + index % 26);
+	for (index /= 26; index != 0; index /= 26) text->push_back('a' + index % 26);
+}
+
+/*
+ * Statements like the ones a program consists of: declarations, assignments, loops, conditionals and the odd comment, over 4096
+ * distinct identifiers.
+ */
+inline std::string generate_program(std::size_t size, std::uint64_t seed = 1) {
+	BenchRandom random(seed);
+	std::string text;
+	text.reserve(size + 128);
+
+	while (text.size() < size) {
+		switch (random.below(6)) {
+		case 0:
+			text += "int ";
+			append_identifier(&text, &random, 4096);
+			text += ";\n";
+			break;
+		case 1:
+			append_identifier(&text, &random, 4096);
+			text += " := ";
+			append_identifier(&text, &random, 4096);
+			text += " * " + std::to_string(random.below(100000)) + " + 3;\n";
+			break;
+		case 2:
+			text += "while (";
+			append_identifier(&text, &random, 4096);
+			text += " < 10) { write(";
+			append_identifier(&text, &random, 4096);
+			text += "); };\n";
+			break;
+		case 3:
+			text += "if (";
+			append_identifier(&text, &random, 4096);
+			text += " =:= 7) { read(x); } else { write(-x); };\n";
+			break;
+		case 4:
+			text += ":* a comment between the statements *:\n";
+			break;
+		default:
+			append_identifier(&text, &random, 4096);
+			text += "[" + std::to_string(random.below(64)) + "] := !(y =:= 100) && z;\n";
+			break;
+		}
+	}
+
+	return text;
+}
+
+/*
+ * Identifiers of 1 to 24 letters and digits out of a vocabulary of distinct ones, separated by blanks and line feeds, with an operator
+ * every few of them.
+ */
+inline std::string generate_identifiers(std::size_t size, std::size_t distinct = 4096, std::uint64_t seed = 2) {
+	const static char ALPHABET[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+	BenchRandom random(seed);
+	std::vector<std::string> vocabulary(distinct);
+
+	for (std::size_t index = 0; index < distinct; index++) {
+		vocabulary[index].push_back(ALPHABET[random.below(52)]);
+		for (std::size_t length = random.below(24); length != 0; length--) vocabulary[index].push_back(ALPHABET[random.below(sizeof(ALPHABET) - 1)]);
+	}
+
+	std::string text;
+	text.reserve(size + 32);
+
+	while (text.size() < size) {
+		text += vocabulary[random.below(distinct)];
+
+		switch (random.below(8)) {
+		case 0:
+			text += " := ";
+			break;
+		case 1:
+			text += ";\n";
+			break;
+		default:
+			text.push_back(' ');
+			break;
+		}
+	}
+
+	return text;
+}
+
+/*
+ * Comments of up to 2 KiB prose, including lone '*', separated by single statements.
+ */
+inline std::string generate_comments(std::size_t size, std::uint64_t seed = 3) {
+	const static char PROSE[] = "the quick brown fox jumps over the lazy dog * 3 = 4\n\t";
+	BenchRandom random(seed);
+	std::string text;
+	text.reserve(size + 2048);
+
+	while (text.size() < size) {
+		text += ":* ";
+		for (std::size_t length = random.below(2048); length != 0; length--) text.push_back(PROSE[random.below(sizeof(PROSE) - 1)]);
+		text += " *:\nx := x + 1;\n";
+	}
+
+	return text;
+}
+
+/*
+ * Overwrites about one in every spacing bytes of text with a random byte, non-ASCII or control, as binary garbage mixed into a source.
+ */
+inline std::string add_garbage(std::string text, std::size_t spacing, std::uint64_t seed = 4) {
+	BenchRandom random(seed);
+
+	for (std::size_t index = random.below(spacing); index < text.size(); index += 1 + random.below(2 * spacing)) {
+		std::size_t byte = random.below(160);
+		text[index] = static_cast<char>(byte < 128 ? 0x80 + byte : byte - 128);
+	}
+
+	return text;
+}
+
+/*
+ * Writes text to a new temporary file and returns its path. The caller removes it.
+ */
+inline std::string write_temporary_file(const std::string& text) {
+	char path[] = "/tmp/bench_input_XXXXXX";
+	int file = ::mkstemp(path);
+	if (file < 0) {
+		std::perror("mkstemp");
+		std::exit(EXIT_FAILURE);
+	}
+
+	for (std::size_t written = 0; written < text.size(); ) {
+		ssize_t count = ::write(file, text.data() + written, text.size() - written);
+		if (count <= 0) {
+			std::perror("write");
+			std::exit(EXIT_FAILURE);
+		}
+		written += count;
+	}
+
+	::close(file);
+	return path;
+}
+
+/*
+ * Returns the smallest wall time of BENCH_RUNS calls of function in seconds.
+ */
+template<typename Function> double best_seconds(Function function) {
+	double best = 0;
+
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		function();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		if (run == 0 || seconds < best) best = seconds;
+	}
+
+	return best;
+}
+
+/*
+ * Drains scanner through the batched API and returns the count of tokens, END_OF_FILE included.
+ */
+template<typename ScannerType> std::size_t count_tokens(ScannerType* scanner) {
+	TokenBlock block;
+	std::size_t count = 0;
+
+	while (true) {
+		std::size_t size = scanner->next_tokens(block);
+		count += size;
+
+		if (block.token_type(size - 1) == TokenType::END_OF_FILE) return count;
+	}
+}
+
+inline void print_result(const char* name, std::size_t bytes, std::size_t tokens, double seconds) {
+	std::printf("  %-28s %8.1f ms %9.1f MB/s %8.2f M tokens/s\n", name, seconds * 1e3, bytes / seconds / 1e6, tokens / seconds / 1e6);
+}
+
+#endif /* BENCH_H */
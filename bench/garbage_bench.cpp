@@ -0,0 +1,42 @@
+#include "bench.h"
+
+/*
+ * Scans a generated program of argv[1] MiB (16 by default) from memory with more and more of its bytes overwritten by binary garbage.
+ * Every garbage byte outside a comment yields an error token, so the cost of an error token shows in the throughput.
+ */
+
+int main(int argc, char* argv[]) {
+	const static std::size_t SPACINGS[] = {0, 1000, 100, 10, 2};
+
+	std::size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16) << 20;
+	std::string program = generate_program(size);
+
+	std::printf("garbage: %zu MiB program from memory\n", size >> 20);
+
+	for (std::size_t spacing : SPACINGS) {
+		std::string text = spacing == 0 ? program : add_garbage(program, spacing);
+		std::size_t tokens = 0, errors = 0;
+
+		double seconds = best_seconds([&]() {
+			Scanner scanner(text.data(), text.data() + text.size());
+			TokenBlock block;
+			tokens = errors = 0;
+
+			while (true) {
+				std::size_t count = scanner.next_tokens(block);
+				tokens += count;
+
+				TokenType type = block.token_type(count - 1);
+				if (type == TokenType::END_OF_FILE) break;
+				if (type == TokenType::DEADBEEF || type == TokenType::UNSUPPORTED_CHARACTER) errors++;
+			}
+		});
+
+		char name[64];
+		if (spacing == 0) std::snprintf(name, sizeof(name), "no garbage");
+		else std::snprintf(name, sizeof(name), "1/%zu, %zu errors", spacing, errors);
+		print_result(name, text.size(), tokens, seconds);
+	}
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+#include "bench.h"
+#include "hash.h"
+#include <cctype>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+/*
+ * Compares the word-at-a-time hash of hash.h against the byte-wise SDBM it replaced, over the distinct identifiers of real sources: the
+ * files and directories given as arguments, or this repository's src and include by default, and over "identifier0" to
+ * "identifier999999", whose hashes differ in their last bytes only. Collisions count equal 64 bit hashes and equal low halves, which a
+ * Symboltable Slot keeps. Probes count the Slots a Symboltable at half load visits per insert, SDBM placed by a Fibonacci multiply as it
+ * was and by its low bits for comparison, the new hash by its low bits.
+ */
+
+typedef std::uint64_t (*Hash)(const char* begin, const char* end);
+
+std::uint64_t sdbm(const char* begin, const char* end) {
+	std::uint64_t hash = 0;
+	for (; begin != end; ++begin) hash = *begin + (hash << 6) + (hash << 16) - hash;
+	return hash;
+}
+
+void add_identifiers(const std::string& path, std::unordered_set<std::string>* identifiers) {
+	DIR* directory = ::opendir(path.c_str());
+
+	if (directory != nullptr) {
+		for (dirent* entry = ::readdir(directory); entry != nullptr; entry = ::readdir(directory)) {
+			if (entry->d_name[0] != '.') add_identifiers(path + "/" + entry->d_name, identifiers);
+		}
+		::closedir(directory);
+		return;
+	}
+
+	std::ifstream file(path.c_str(), std::ios::binary);
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	for (std::size_t index = 0; index < text.size(); ) {
+		char symbol = text[index];
+		if (!(std::isalpha(static_cast<unsigned char>(symbol)) || symbol == '_')) {
+			index++;
+			continue;
+		}
+
+		std::size_t begin = index;
+		while (index < text.size() && (std::isalnum(static_cast<unsigned char>(text[index])) || text[index] == '_')) index++;
+		identifiers->insert(text.substr(begin, index - begin));
+	}
+}
+
+void bench_hash(const char* name, const std::vector<std::string>& identifiers, Hash hash, bool fibonacci) {
+	std::vector<std::uint64_t> hashes(identifiers.size());
+	std::size_t bytes = 0;
+
+	for (std::size_t index = 0; index < identifiers.size(); index++) {
+		hashes[index] = hash(identifiers[index].data(), identifiers[index].data() + identifiers[index].size());
+		bytes += identifiers[index].size();
+	}
+
+	std::unordered_set<std::uint64_t> distinct(hashes.begin(), hashes.end()), distinct_low;
+	for (std::uint64_t value : hashes) distinct_low.insert(static_cast<std::uint32_t>(value));
+
+	std::size_t slot_mask = 1, probes = 0;
+	while (slot_mask + 1 < 2 * identifiers.size()) slot_mask = (slot_mask << 1) | 1;
+	std::vector<char> taken(slot_mask + 1);
+
+	for (std::uint64_t value : hashes) {
+		std::size_t index = (fibonacci ? (value * 0x9E3779B97F4A7C15) >> 32 : value) & slot_mask;
+		for (probes++; taken[index]; probes++) index = (index + 1) & slot_mask;
+		taken[index] = 1;
+	}
+
+	std::uint64_t checksum = 0;
+	double seconds = best_seconds([&]() {
+		for (const std::string& identifier : identifiers) checksum += hash(identifier.data(), identifier.data() + identifier.size());
+	});
+
+	std::printf("  %-14s %6zu %6zu %8.3f %8.2f ns/id %6.2f GB/s (%llu)\n", name, identifiers.size() - distinct.size(),
+		identifiers.size() - distinct_low.size(), static_cast<double>(probes) / identifiers.size(), seconds * 1e9 / identifiers.size(),
+		bytes / seconds / 1e9, static_cast<unsigned long long>(checksum & 1));
+}
+
+void bench_corpus(const char* name, const std::vector<std::string>& identifiers) {
+	std::printf("%s: %zu distinct identifiers\n", name, identifiers.size());
+	std::printf("  %-14s %6s %6s %8s\n", "hash", "64 bit", "32 bit", "probes");
+	bench_hash("SDBM", identifiers, sdbm, true);
+	bench_hash("SDBM, low bits", identifiers, sdbm, false);
+	bench_hash("word-at-a-time", identifiers, hash_bytes, false);
+}
+
+int main(int argc, char* argv[]) {
+	std::unordered_set<std::string> sources;
+
+	if (argc > 1) for (int index = 1; index < argc; index++) add_identifiers(argv[index], &sources);
+	else {
+		add_identifiers("src", &sources);
+		add_identifiers("include", &sources);
+	}
+
+	bench_corpus("sources", std::vector<std::string>(sources.begin(), sources.end()));
+
+	std::vector<std::string> sequential(1000000);
+	for (std::size_t index = 0; index < sequential.size(); index++) sequential[index] = "identifier" + std::to_string(index);
+	bench_corpus("identifier0 to identifier999999", sequential);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "bench.h"
+#include <thread>
+
+/*
+ * Scans a generated program of argv[1] MiB (64 by default) from a regular file and from a pipe, each synchronously and with a read-ahead
+ * thread. A regular file is mapped unless it is read ahead; a pipe is read chunk by chunk, which is the path read-ahead targets.
+ */
+
+/*
+ * Opens a new pipe fed by a writer thread and returns the path the Scanner opens it by.
+ */
+class PipeSource {
+private:
+	int ends[2];
+	std::thread writer;
+
+public:
+	explicit PipeSource(const std::string& text) {
+		if (::pipe(this->ends) != 0) {
+			std::perror("pipe");
+			std::exit(EXIT_FAILURE);
+		}
+
+		int input = this->ends[1];
+		this->writer = std::thread([input, &text]() {
+			for (std::size_t written = 0; written < text.size(); ) {
+				ssize_t count = ::write(input, text.data() + written, text.size() - written);
+				if (count <= 0) break;
+				written += count;
+			}
+			::close(input);
+		});
+	}
+
+	~PipeSource() {
+		this->writer.join();
+		::close(this->ends[0]);
+	}
+
+	std::string path() const {
+		return "/dev/fd/" + std::to_string(this->ends[0]);
+	}
+};
+
+std::size_t scan_file(const std::string& path, std::size_t read_ahead_chunks) {
+	Scanner scanner(path.c_str(), read_ahead_chunks);
+	return count_tokens(&scanner);
+}
+
+std::size_t scan_pipe(const std::string& text, std::size_t read_ahead_chunks) {
+	PipeSource source(text);
+	return scan_file(source.path(), read_ahead_chunks);
+}
+
+int main(int argc, char* argv[]) {
+	std::size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64) << 20;
+	std::string text = generate_program(size);
+	std::string path = write_temporary_file(text);
+	std::size_t tokens = 0;
+
+	std::printf("read-ahead: %zu MiB program\n", size >> 20);
+
+	print_result("file, mapped", text.size(), tokens, best_seconds([&]() { tokens = scan_file(path, 0); }));
+	print_result("file, read-ahead 16", text.size(), tokens, best_seconds([&]() { tokens = scan_file(path, 16); }));
+	print_result("pipe, synchronous", text.size(), tokens, best_seconds([&]() { tokens = scan_pipe(text, 0); }));
+	print_result("pipe, read-ahead 4", text.size(), tokens, best_seconds([&]() { tokens = scan_pipe(text, 4); }));
+	print_result("pipe, read-ahead 16", text.size(), tokens, best_seconds([&]() { tokens = scan_pipe(text, 16); }));
+
+	::unlink(path.c_str());
+	return 0;
+}
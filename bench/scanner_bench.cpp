@@ -0,0 +1,28 @@
+#include "bench.h"
+
+/*
+ * Scans generated inputs of argv[1] MiB (16 by default) from memory, so only the automaton and the token construction are measured:
+ * identifiers, where every byte takes a transition, comments, where the skip kernels cover most bytes, and a mixed program.
+ */
+
+void bench_scan(const char* name, const std::string& text) {
+	std::size_t tokens = 0;
+	double seconds = best_seconds([&]() {
+		Scanner scanner(text.data(), text.data() + text.size());
+		tokens = count_tokens(&scanner);
+	});
+
+	print_result(name, text.size(), tokens, seconds);
+}
+
+int main(int argc, char* argv[]) {
+	std::size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16) << 20;
+
+	std::printf("scanner: %zu MiB inputs from memory\n", size >> 20);
+
+	bench_scan("identifiers", generate_identifiers(size));
+	bench_scan("comments", generate_comments(size));
+	bench_scan("program", generate_program(size));
+
+	return 0;
+}
@@ -0,0 +1,47 @@
+#include "bench.h"
+#include "symboltable.h"
+
+/*
+ * Interns 10 to 10^6 distinct identifiers of 4 to 31 bytes, so both lexems within a Slot's prefix and longer ones are measured, then
+ * inserts argv[1] million (4 by default) of them again in random order, as the Scanner does for every known identifier.
+ */
+
+int main(int argc, char* argv[]) {
+	const static char ALPHABET[] = "abcdefghijklmnopqrstuvwxyz_0123456789";
+
+	std::size_t repeats = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4) * 1000000;
+
+	std::printf("symboltable: %zu M repeated inserts\n", repeats / 1000000);
+
+	for (std::size_t symbols = 10; symbols <= 1000000; symbols *= 10) {
+		BenchRandom random(symbols);
+		std::vector<std::string> names(symbols);
+
+		for (std::size_t index = 0; index < symbols; index++) {
+			names[index].push_back(ALPHABET[random.below(26)]);
+			for (std::size_t length = 3 + random.below(22); length != 0; length--) names[index].push_back(ALPHABET[random.below(sizeof(ALPHABET) - 1)]);
+			names[index] += std::to_string(index);
+		}
+
+		std::vector<std::uint32_t> order(repeats);
+		for (std::size_t index = 0; index < repeats; index++) order[index] = static_cast<std::uint32_t>(random.below(symbols));
+
+		std::size_t checksum = 0;
+		double insert_seconds = best_seconds([&]() {
+			Symboltable symboltable;
+			for (const std::string& name : names) symboltable.insert(Lexeme(name.data(), name.size()), TokenType::IDENTIFIER);
+		});
+
+		Symboltable symboltable;
+		for (const std::string& name : names) symboltable.insert(Lexeme(name.data(), name.size()), TokenType::IDENTIFIER);
+
+		double repeat_seconds = best_seconds([&]() {
+			for (std::uint32_t index : order) checksum += symboltable.insert(Lexeme(names[index].data(), names[index].size()), TokenType::IDENTIFIER);
+		});
+
+		std::printf("  %8zu symbols %8.1f ns/insert %8.1f ns/repeated insert (%zu)\n", symbols, insert_seconds * 1e9 / symbols,
+			repeat_seconds * 1e9 / repeats, checksum & 1);
+	}
+
+	return 0;
+}
@@ -29,8 +29,11 @@ private:
 
 public:
 	BinaryGraveyardIterator(Vector<pointer_type>* graves, typename Vector<pointer_type>::iterator active_grave)
-		: graves(graves), active_grave(active_grave - 1), iterator(nullptr), corpses_before_grave_end(1) {
-		this->next();
+		: graves(graves), active_grave(active_grave), iterator(nullptr), corpses_before_grave_end(1) {
+		if (this->active_grave != this->graves->end()) {
+			this->iterator = *this->active_grave;
+			this->corpses_before_grave_end = BinaryGraveyard<value_type>::grave_size(this->iterator);
+		}
 	}
 
 	BinaryGraveyardIterator& operator++() {
@@ -103,8 +106,10 @@ private:
 	}
 
 	void dig_grave(std::size_t required_space) {
-		this->next_free_space = static_cast<char*>(::operator new(((required_space - 1) | (GRAVE_CAPACITY - 1)) + 1));
-		this->end_free_space = this->next_free_space + required_space;
+		std::size_t grave_capacity = ((required_space - 1) | (GRAVE_CAPACITY - 1)) + 1;
+
+		this->next_free_space = static_cast<char*>(::operator new(grave_capacity));
+		this->end_free_space = this->next_free_space + grave_capacity;
 
 		this->graveyard.push_back(this->next_free_space);
 	}
@@ -117,6 +122,34 @@ private:
 		return false;
 	}
 
+	/*
+	 * Reserves the space of a grave for count corpses and returns its address, the caller constructs them there.
+	 */
+	pointer_type prepare_grave(std::size_t count) {
+		std::size_t* size_address;
+		pointer_type value_address;
+		std::size_t required_space = this->required_space(size_address, value_address, count);
+
+		if (this->dig_grave_on_demand(required_space)) this->required_space(size_address, value_address, count);
+
+		*size_address = count;
+
+		this->graves.push_back(value_address);
+		this->next_free_space = reinterpret_cast<char*>(value_address) + (count * sizeof(value_type));
+
+		return value_address;
+	}
+
+	/*
+	 * Forgets the last grave, whose corpses failed to construct, and returns the free space from before prepare_grave(). A grave dug
+	 * for it stays in the graveyard and is freed with it.
+	 */
+	void abandon_grave(char* next_free_space, char* end_free_space) {
+		this->graves.pop_back();
+		this->next_free_space = next_free_space;
+		this->end_free_space = end_free_space;
+	}
+
 	template<typename U = value_type> typename std::enable_if<std::is_trivially_destructible<U>::value>::type desecrate() {}
 	template<typename U = value_type> typename std::enable_if<!std::is_trivially_destructible<U>::value>::type desecrate() {
 		for (iterator iterator = this->begin(), end = this->end(); iterator != end; ++iterator) {
@@ -136,8 +169,8 @@ public:
 
 	BinaryGraveyard(const BinaryGraveyard<value_type>& source) : graveyard(source.graveyard), next_free_space(nullptr), end_free_space(nullptr) {
 		if (source.graveyard.size() > 0) {
-			char* source_grave_begin = static_cast<char*>(&*(source.graveyard.cend() - 1));
-			char* this_grave_begin = static_cast<char*>(&*(this->graveyard.cend() - 1));
+			char* source_grave_begin = static_cast<char*>(*(source.graveyard.cend() - 1));
+			char* this_grave_begin = static_cast<char*>(*(this->graveyard.cend() - 1));
 
 			this->next_free_space = this_grave_begin + std::distance(source_grave_begin, source.next_free_space);
 			this->end_free_space = this_grave_begin + std::distance(source_grave_begin, source.end_free_space);
@@ -157,18 +190,36 @@ public:
 		return *this->bury(&corpse, 1);
 	}
 
-	pointer_type bury(const_pointer_type corpse, std::size_t count) {
-		std::size_t* size_address;
-		pointer_type value_address;
-		std::size_t required_space = this->required_space(size_address, value_address, count);
+	/*
+	 * Constructs the corpse right in its grave from args, so a corpse owning memory, like a String, is never copied. If its constructor
+	 * throws, the graveyard is left as it was.
+	 */
+	template<typename... Args> reference emplace(Args&&... args) {
+		char *next_free_space = this->next_free_space, *end_free_space = this->end_free_space;
+		pointer_type value_address = this->prepare_grave(1);
 
-		if (this->dig_grave_on_demand(required_space)) this->required_space(size_address, value_address, count);
+		try {
+			new (static_cast<void*>(value_address)) value_type(std::forward<Args>(args)...);
+		}
+		catch(...) {
+			this->abandon_grave(next_free_space, end_free_space);
+			throw;
+		}
 
-		*size_address = count;
-		std::uninitialized_copy(corpse, corpse + count, value_address);
+		return *value_address;
+	}
 
-		this->graves.push_back(value_address);
-		this->next_free_space = reinterpret_cast<char*>(value_address) + (count * sizeof(value_type));
+	pointer_type bury(const_pointer_type corpse, std::size_t count) {
+		char *next_free_space = this->next_free_space, *end_free_space = this->end_free_space;
+		pointer_type value_address = this->prepare_grave(count);
+
+		try {
+			std::uninitialized_copy(corpse, corpse + count, value_address);
+		}
+		catch(...) {
+			this->abandon_grave(next_free_space, end_free_space);
+			throw;
+		}
 
 		return value_address;
 	}
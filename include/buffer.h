@@ -1,29 +1,50 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
-#include <fstream>
 #include "string.h"
+#include "read_ahead.h"
+#include "line_index.h"
 
 
+/**
+* Buffer maps regular files into memory, so get() and unget() are plain pointer moves. Sources that can't be mapped, like pipes or
+* the standard input, are read in chunks of buffer_size bytes into a sliding window, which keeps the last lookback bytes of the
+* previous chunk. Thus unget() never has to seek, as long as it isn't called more than lookback times in a row.
+* Additionally, every byte from the last mark() on is kept, growing the window if needed, so a lexeme can be referred to in place.
+* If read_ahead_chunks is non-zero, the source is never mapped, but read ahead by a background thread instead.
+* A Buffer may also serve a range of bytes owned by someone else, like a segment of another Buffer's mapping.
+* Offsets count the bytes of the source in front of a byte. The LineIndex of the source defers the bytes kept in memory as a whole and
+* indexes every chunk read into the window.
+**/
 class Buffer {
 private:
 	const static int BUFFER_SIZE = 4096;
-	char *begin, *end, *next, *back_buffer_begin, *back_buffer_end;
-	bool next_chunk_loaded, previous_chunk_loaded;
-	std::size_t buffer_size;
-	bool injected_newline, seek_double_buffer_size;
+	const static char* const STANDARD_INPUT;
 
-	std::ifstream source;
+	char *begin, *end, *next, *marker;
+	std::size_t origin;
+	bool injected_newline;
+	LineIndex line_index;
 
-	void read_next_chunk();
-	void read_previous_chunk();
-	void read_next_chunk_on_demand();
-	void read_previous_chunk_on_demand();
-	void switch_buffer();
-	void inject_newline();
+	char *mapping;
+	std::size_t mapping_size;
+
+	int source;
+	char *window;
+	std::size_t window_size, lookback, buffer_size;
+	ReadAhead* read_ahead;
+
+	void limit_size(std::size_t size) const;
+	bool map_file(int descriptor);
+	void open_window(std::size_t lookback, std::size_t buffer_size);
+	bool read_next_chunk();
+	int inject_newline();
 
 public:
-	explicit Buffer(const String& file, std::size_t buffer_size = BUFFER_SIZE);
+	const static int END_OF_SOURCE = -1;
+
+	Buffer(const String& file, std::size_t lookback, std::size_t read_ahead_chunks = 0, std::size_t buffer_size = BUFFER_SIZE);
+	Buffer(const char* begin, const char* end);
 	~Buffer();
 
 	Buffer(const Buffer& source) = delete;
@@ -31,8 +52,33 @@ public:
 	Buffer& operator=(const Buffer& source) = delete;
 	Buffer& operator=(const Buffer&& source) = delete;
 
-	char get();
+	bool is_memory_mapped() const { return this->mapping != nullptr; }
+
+	/*
+	 * Returns the next byte as unsigned char, or END_OF_SOURCE once the source and the newline terminating it are exhausted.
+	 */
+	int get();
 	char unget();
+
+	/*
+	 * Marks the position of the next byte. marked() stays valid until the next call of get() or skip_to(), which may move the window.
+	 */
+	void mark() { this->marker = this->next; }
+	const char* marked() const { return this->marker; }
+
+	/*
+	 * The bytes get() returns next without reading from the source, so runs of them can be consumed at once by skip_to().
+	 */
+	const char* pending_begin() const { return this->next; }
+	const char* pending_end() const { return this->end; }
+	void skip_to(const char* position) { this->next = const_cast<char*>(position); }
+
+	/*
+	 * Returns the offset of a byte between the window's begin and end.
+	 */
+	std::uint32_t offset(const char* byte) const { return static_cast<std::uint32_t>(this->origin + (byte - this->begin)); }
+
+	LineIndex& get_line_index() { return this->line_index; }
 };
 
 #endif /* BUFFER_H */
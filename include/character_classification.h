@@ -1,6 +1,10 @@
 #ifndef CHARACTER_CLASSIFICATION_H
 #define CHARACTER_CLASSIFICATION_H
 
+inline bool is_ascii(int symbol) {
+    return symbol >= 0 && symbol <= 0x7F;
+}
+
 inline bool is_alpha(char symbol) {
     return (symbol >= 'a' && symbol <= 'z') || (symbol >= 'A' && symbol <= 'Z');
 }
@@ -48,7 +48,7 @@ public:
 
 class CommandLineMissingArgumentsException : public ParserException {
 public:
-	CommandLineMissingArgumentsException(const char* executable) : ParserException(std::string("Usage: ") + std::string(executable) + std::string(" <IN FILE> <OUT FILE>")) {}
+	CommandLineMissingArgumentsException(const char* executable) : ParserException(std::string("Usage: ") + std::string(executable) + std::string(" <IN FILE> <OUT FILE> [--read-ahead=<CHUNKS>] [--jobs=<THREADS>]")) {}
 };
 
 class TokenGeneratingException : public ParserException {
@@ -66,6 +66,11 @@ public:
 	TooManyMachineStatesException(const std::string& occurrence, size_t maximum, size_t given) : ParserException(occurrence + std::string(" got ") + std::to_string(given) + std::string(" States, which is above the maximum supported amount of ") + std::to_string(maximum) + std::string(" states")) {}
 };
 
+class UnboundedBacktrackException : public ParserException {
+public:
+	UnboundedBacktrackException(const std::string& occurrence) : ParserException(occurrence + std::string(" detected a cycle of non-final states, so the amount of symbols to backtrack is unbounded")) {}
+};
+
 class FatalException : public ParserException {
 public:
 	FatalException(const std::string& occurrence, const std::string& description) : ParserException(std::string("Error in ") + occurrence + std::string(": ") + description) {}
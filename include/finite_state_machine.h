@@ -1,209 +1,330 @@
-#ifndef FINITE_STATE_MACHINE_H
-#define FINITE_STATE_MACHINE_H
-
-#include <limits>
-#include <iterator>
-#include <functional>
-#include "vector.h"
-#include "token.h"
-#include "exception.h"
-
-
-enum class StateType {
-	REGULAR,
-	FINAL,
-	CALLBACK_FINAL
-};
-
-class Transition;
-
-/**
-* State MUST NOT outlive the Transitions* passed to it! => TODO: implement shared_ptr
-**/
-class State {
-private:
-	Vector<const Transition*> transitions;
-
-public:
-	explicit State(const Vector<const Transition*>& transitions) : transitions(transitions) {}
-	explicit State(const Transition *transition) : transitions(1, transition) {}
-	explicit State(std::initializer_list<const Transition*> transitions) : transitions(transitions.begin(), transitions.end()) {}
-	virtual ~State() = default;
-
-	const Vector<const Transition*>& get_transitions() const { return this->transitions; }
-
-	void add(const Vector<const Transition*>& transitions) {
-		this->transitions.insert(this->transitions.end(), transitions.cbegin(), transitions.cend());
-	}
-
-	void add(const Transition *transition) {
-		this->transitions.push_back(transition);
-	}
-
-	virtual StateType type() const {
-		return StateType::REGULAR;
-	}
-
-	/**
-	* TODO: implement destructor that checks transitions for Transitions that refer to the State being destructed and manually
-	* remove ownership of this State from the shared_ptr, so it doesn't get destructed twice
-	**/
-};
-
-
-class FinalState : public State {
-private:
-	TokenType generate_token;
-
-public:
-	explicit FinalState(TokenType generate_token, const Vector<const Transition*>& transitions = Vector<const Transition*>::EMPTY)
-		: State(transitions), generate_token(generate_token) {};
-
-	FinalState(TokenType generate_token, const Transition *transition) : State(transition), generate_token(generate_token) {}
-
-	TokenType token() const { return this->generate_token; }
-
-	StateType type() const override {
-		return StateType::FINAL;
-	}
-};
-
-enum class Direction {
-	ENTER,
-	EXIT
-};
-
-class CallbackFinalState : public FinalState {
-private:
-	std::function<void(Direction, char)> callback;
-public:
-	CallbackFinalState(TokenType generate_token, const Transition *transition, std::function<void(Direction, char)> callback)
-		: FinalState(generate_token, transition), callback(callback) {}
-
-	CallbackFinalState(TokenType generate_token, std::function<void(Direction, char)> callback) : FinalState(generate_token), callback(callback) {}
-
-	StateType type() const override {
-		return StateType::CALLBACK_FINAL;
-	}
-
-	void operator()(Direction direction, char symbol) const {
-		this->callback(direction, symbol);
-	}
-};
-
-enum class TransitionType : unsigned char {
-	CHAR,
-	TYPE
-};
-
-/**
-
-* Important: Transition MUST NOT outlive the State* passed to it. => TODO: implement shared_ptr
-
-**/
-class Transition {
-private:
-	const State *next_state;
-
-protected:
-	Transition(const State *next_state) : next_state(next_state) {}
-
-public:
-	const State* get_next_state() const { return this->next_state; }
-	virtual const State* process(char symbol) const = 0;
-	virtual TransitionType type() const = 0;
-};
-
-
-class CharTransition : public Transition {
-private:
-	char symbol;
-
-public:
-	CharTransition(const State *next_state, char symbol) : Transition(next_state), symbol(symbol) {}
-	char get_symbol() const { return this->symbol; }
-	const State* process(char symbol) const override;
-	TransitionType type() const override { return TransitionType::CHAR; }
-};
-
-
-enum class CharClass : char {
-	NUMERIC,
-	ALPHA,
-	ALPHA_NUMERIC,
-	ANY
-};
-
-
-class TypeTransition : public Transition {
-private:
-	const static Vector<char> NUMERIC_VALUES, ALPHA_VALUES, ALPHA_NUMERIC_VALUES, ANY_VALUES;
-
-	CharClass char_class;
-
-public:
-	TypeTransition(const State *next_state, CharClass type) : Transition(next_state), char_class(type) {}
-	CharClass get_type() const { return this->char_class; }
-	const State* process(char symbol) const override;
-	const Vector<char>& values() const;
-	TransitionType type() const override { return TransitionType::TYPE; }
-};
-
-
-template<typename T> class BranchMatrix {
-private:
-	Vector<T> values;
-	const std::size_t dimension_y;
-
-public:
-	BranchMatrix(const std::size_t dimension_x, const std::size_t dimension_y, const T& default_value = T())
-		: values(dimension_x * dimension_y, default_value), dimension_y(dimension_y) {}
-
-	void set(const std::size_t dimension_x, const std::size_t dimension_y, const T& object) {
-		this->values[dimension_x * this->dimension_y + dimension_y] = object;
-	}
-
-	const T& get(const std::size_t dimension_x, const std::size_t dimension_y) const {
-		return this->values[dimension_x * this->dimension_y + dimension_y];
-	}
-
-};
-
-
-class FiniteStateMachine {
-public:
-	typedef unsigned char state_type;
-
-private:
-	const static state_type CRASH_STATE_ID, START_STATE_ID;
-	const static FinalState CRASH_STATE;
-	const static unsigned char SUPPORTED_ENCODING_MAX_VALUE;
-	const static std::size_t STATE_TYPE_MAX;
-
-	Vector<const State*> states;
-	state_type current_state;
-	BranchMatrix<state_type> branch_matrix;
-	std::size_t steps_since_last_final_state;
-	state_type last_final_state_index;
-
-	static const Vector<const State*> gather_states(const State* start);
-	void init_branch_matrix();
-	void branch_matrix_entry(const Transition* transition, state_type current_state_index, state_type next_state_index);
-	void branch_matrix_entry(state_type symbol, state_type current_state_index, state_type next_state_index);
-	void branch_matrix_entry(const TypeTransition& transition, state_type current_state_index, state_type next_state_index);
-	bool is_final_state(const State* state) const;
-	void trigger_callback_state_handler(const State* state, Direction direction, char symbol) const;
-
-	void check_encoding(state_type value) {
-		if (value > FiniteStateMachine::SUPPORTED_ENCODING_MAX_VALUE) throw UnsupportedCharacterEncodingException("FiniteStateMachine::check_encoding(state_type)", "ASCII", value);
-	}
-
-public:
-	FiniteStateMachine(const State* start);
-	bool process(char symbol);
-	std::size_t get_steps_since_last_final_state() const;
-	const FinalState& get_last_final_state() const;
-	void reset();
-};
-
-#endif /* Automaton_H_ */
+#ifndef FINITE_STATE_MACHINE_H
+#define FINITE_STATE_MACHINE_H
+
+#include <limits>
+#include <iterator>
+#include <functional>
+#include "vector.h"
+#include "token.h"
+#include "exception.h"
+#include "skip_kernels.h"
+
+
+enum class StateType {
+	REGULAR,
+	FINAL,
+	CALLBACK_FINAL
+};
+
+class Transition;
+
+/**
+* State MUST NOT outlive the Transitions* passed to it! => TODO: implement shared_ptr
+**/
+class State {
+private:
+	Vector<const Transition*> transitions;
+
+public:
+	explicit State(const Vector<const Transition*>& transitions) : transitions(transitions) {}
+	explicit State(const Transition *transition) : transitions(1, transition) {}
+	explicit State(std::initializer_list<const Transition*> transitions) : transitions(transitions.begin(), transitions.end()) {}
+	virtual ~State() = default;
+
+	const Vector<const Transition*>& get_transitions() const { return this->transitions; }
+
+	void add(const Vector<const Transition*>& transitions) {
+		this->transitions.insert(this->transitions.end(), transitions.cbegin(), transitions.cend());
+	}
+
+	void add(const Transition *transition) {
+		this->transitions.push_back(transition);
+	}
+
+	virtual StateType type() const {
+		return StateType::REGULAR;
+	}
+
+	/**
+	* TODO: implement destructor that checks transitions for Transitions that refer to the State being destructed and manually
+	* remove ownership of this State from the shared_ptr, so it doesn't get destructed twice
+	**/
+};
+
+
+class FinalState : public State {
+private:
+	TokenType generate_token;
+
+public:
+	explicit FinalState(TokenType generate_token, const Vector<const Transition*>& transitions = Vector<const Transition*>::EMPTY)
+		: State(transitions), generate_token(generate_token) {};
+
+	FinalState(TokenType generate_token, const Transition *transition) : State(transition), generate_token(generate_token) {}
+
+	TokenType token() const { return this->generate_token; }
+
+	StateType type() const override {
+		return StateType::FINAL;
+	}
+};
+
+enum class Direction {
+	ENTER,
+	EXIT
+};
+
+class CallbackFinalState : public FinalState {
+private:
+	std::function<void(Direction, char)> callback;
+public:
+	CallbackFinalState(TokenType generate_token, const Transition *transition, std::function<void(Direction, char)> callback)
+		: FinalState(generate_token, transition), callback(callback) {}
+
+	CallbackFinalState(TokenType generate_token, std::function<void(Direction, char)> callback) : FinalState(generate_token), callback(callback) {}
+
+	StateType type() const override {
+		return StateType::CALLBACK_FINAL;
+	}
+
+	void operator()(Direction direction, char symbol) const {
+		this->callback(direction, symbol);
+	}
+};
+
+enum class TransitionType : unsigned char {
+	CHAR,
+	TYPE,
+	RANGE
+};
+
+/**
+
+* Important: Transition MUST NOT outlive the State* passed to it. => TODO: implement shared_ptr
+
+**/
+class Transition {
+private:
+	const State *next_state;
+
+protected:
+	Transition(const State *next_state) : next_state(next_state) {}
+
+public:
+	const State* get_next_state() const { return this->next_state; }
+	virtual const State* process(char symbol) const = 0;
+	virtual TransitionType type() const = 0;
+};
+
+
+class CharTransition : public Transition {
+private:
+	char symbol;
+
+public:
+	CharTransition(const State *next_state, char symbol) : Transition(next_state), symbol(symbol) {}
+	char get_symbol() const { return this->symbol; }
+	const State* process(char symbol) const override;
+	TransitionType type() const override { return TransitionType::CHAR; }
+};
+
+
+enum class CharClass : char {
+	NUMERIC,
+	ALPHA,
+	ALPHA_NUMERIC,
+	ANY
+};
+
+
+class TypeTransition : public Transition {
+private:
+	const static Vector<char> NUMERIC_VALUES, ALPHA_VALUES, ALPHA_NUMERIC_VALUES, ANY_VALUES;
+
+	CharClass char_class;
+
+public:
+	TypeTransition(const State *next_state, CharClass type) : Transition(next_state), char_class(type) {}
+	CharClass get_type() const { return this->char_class; }
+	const State* process(char symbol) const override;
+	const Vector<char>& values() const;
+	TransitionType type() const override { return TransitionType::TYPE; }
+};
+
+
+/**
+* Transition on any byte from first up to and including last, e.g. for the lead and continuation bytes of UTF-8 sequences.
+**/
+class RangeTransition : public Transition {
+private:
+	unsigned char first, last;
+
+public:
+	RangeTransition(const State *next_state, unsigned char first, unsigned char last) : Transition(next_state), first(first), last(last) {}
+	unsigned char get_first() const { return this->first; }
+	unsigned char get_last() const { return this->last; }
+	const State* process(char symbol) const override;
+	TransitionType type() const override { return TransitionType::RANGE; }
+};
+
+
+template<typename T> class BranchMatrix {
+private:
+	Vector<T> values;
+	const std::size_t dimension_y;
+
+public:
+	BranchMatrix(const std::size_t dimension_x, const std::size_t dimension_y, const T& default_value = T())
+		: values(dimension_x * dimension_y, default_value), dimension_y(dimension_y) {}
+
+	void set(const std::size_t dimension_x, const std::size_t dimension_y, const T& object) {
+		this->values[dimension_x * this->dimension_y + dimension_y] = object;
+	}
+
+	const T& get(const std::size_t dimension_x, const std::size_t dimension_y) const {
+		return this->values[dimension_x * this->dimension_y + dimension_y];
+	}
+
+	std::size_t size_x() const {
+		return this->values.size() / this->dimension_y;
+	}
+
+	std::size_t size_y() const {
+		return this->dimension_y;
+	}
+
+	const T* data() const {
+		return this->values.cbegin();
+	}
+
+};
+
+
+/**
+* Plain view of the tables driving a FiniteStateMachine, so they can be generated at build time (see generate_scanner_tables.cpp).
+* branch_matrix holds state_count x symbol_class_count next state IDs, symbol_classes maps each of the 256 byte values to its symbol class.
+* skip_kernels holds the SkipKernel of every state, whose set of bytes the state loops on.
+**/
+struct AutomatonTables {
+	std::size_t state_count;
+	std::size_t symbol_class_count;
+	std::size_t max_steps_since_last_final_state;
+	const unsigned char* symbol_classes;
+	const unsigned char* branch_matrix;
+	const StateType* state_types;
+	const TokenType* tokens;
+	const SkipKernel* skip_kernels;
+};
+
+
+/**
+* The automaton itself: immutable once constructed, so one instance can be shared by any number of FiniteStateMachineCursors and threads.
+* Scanning state lives in the cursors.
+**/
+class FiniteStateMachine {
+public:
+	typedef unsigned char state_type;
+
+private:
+	friend class FiniteStateMachineCursor;
+
+	const static state_type CRASH_STATE_ID, START_STATE_ID;
+	const static FinalState CRASH_STATE;
+	const static std::size_t STATE_TYPE_MAX, SYMBOL_COUNT;
+
+	Vector<const State*> states;
+	Vector<StateType> state_types;
+	bool callbacks_enabled;
+	Vector<state_type> symbol_classes;
+	BranchMatrix<state_type> branch_matrix;
+	Vector<TokenType> tokens;
+	Vector<SkipKernel> skip_kernels;
+	AutomatonTables tables;
+
+	static const Vector<const State*> gather_states(const State* start);
+	BranchMatrix<state_type> init_branch_matrix() const;
+	void branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const Transition* transition, state_type current_state_index, state_type next_state_index) const;
+	void branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, state_type symbol, state_type current_state_index, state_type next_state_index) const;
+	void branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const TypeTransition& transition, state_type current_state_index, state_type next_state_index) const;
+	void branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const RangeTransition& transition, state_type current_state_index, state_type next_state_index) const;
+	BranchMatrix<state_type> minimize(const BranchMatrix<state_type>& branch_matrix);
+	bool equivalent_state_kind(state_type left, state_type right) const;
+	static BranchMatrix<state_type> compress_branch_matrix(const BranchMatrix<state_type>& branch_matrix, Vector<state_type>* symbol_classes);
+	static bool equal_columns(const BranchMatrix<state_type>& branch_matrix, std::size_t left, std::size_t right);
+	static const Vector<StateType> gather_state_types(const Vector<const State*>& states);
+	void init_tables();
+	std::size_t init_max_steps_since_last_final_state() const;
+	SkipKernel init_skip_kernel(state_type state) const;
+	state_type next_state(state_type state, std::size_t symbol_class) const;
+	bool is_final_state(state_type state) const;
+	std::size_t regular_chain_length(state_type state, Vector<std::size_t>* lengths, Vector<bool>* visiting) const;
+	void trigger_callback_state_handler(state_type state, Direction direction, char symbol) const;
+
+public:
+	/*
+	 * If callbacks_enabled is false, the CallbackFinalStates of the graph behave like plain FinalStates and the caller is responsible
+	 * for whatever the callbacks would have tracked.
+	 */
+	explicit FiniteStateMachine(const State* start, bool callbacks_enabled = true);
+
+	/*
+	 * Runs on previously generated tables without any construction work. The tables must outlive the FiniteStateMachine.
+	 */
+	explicit FiniteStateMachine(const AutomatonTables& tables);
+
+	FiniteStateMachine(const FiniteStateMachine& source) = delete;
+	FiniteStateMachine(FiniteStateMachine&& source) = default;
+	FiniteStateMachine& operator=(const FiniteStateMachine& source) = delete;
+
+	std::size_t get_max_steps_since_last_final_state() const;
+	const AutomatonTables& get_tables() const;
+};
+
+
+/**
+* Per scan position within a shared FiniteStateMachine. FiniteStateMachineCursor MUST NOT outlive its FiniteStateMachine!
+**/
+class FiniteStateMachineCursor {
+private:
+	typedef FiniteStateMachine::state_type state_type;
+
+	const FiniteStateMachine* finite_state_machine;
+	state_type current_state;
+	std::size_t steps_since_last_final_state;
+	state_type last_final_state_index;
+
+public:
+	explicit FiniteStateMachineCursor(const FiniteStateMachine& finite_state_machine);
+
+	bool process(char symbol);
+
+	/*
+	 * Processes the symbols from begin on, as long as the machine doesn't crash, and returns the first symbol not processed. Stops behind
+	 * the symbol entering a state with a SkipKernel, so the caller can consume the run it loops on.
+	 */
+	const char* process(const char* begin, const char* end);
+
+	/*
+	 * Returns whether processing symbol would not crash the machine, without processing it.
+	 */
+	bool accepts(char symbol) const;
+
+	std::size_t get_steps_since_last_final_state() const;
+	TokenType get_last_final_token() const;
+	void reset();
+
+	/*
+	 * Returns to the last final state, as if the symbols processed since had never been.
+	 */
+	void resume_last_final_state();
+
+	/*
+	 * The current state loops on every byte of the returned SkipKernel's set, so a caller may consume a whole run of them without
+	 * calling process().
+	 */
+	SkipKernel get_skip_kernel() const {
+		return this->finite_state_machine->tables.skip_kernels[this->current_state];
+	}
+};
+
+#endif /* Automaton_H_ */
@@ -0,0 +1,72 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+* Hashes byte strings 8 bytes per step: every word and the state are multiplied into a 128 bit product, which is folded back into the
+* state, so every bit of a word reaches every bit of the state. The state only ever consumes whole words, so a caller can feed the words
+* of a lexem run by run, as it is scanned, and finish the hash with the remaining bytes once the lexem ends.
+**/
+
+const std::size_t HASH_WORD_SIZE = 8;
+
+inline std::uint64_t hash_word(std::uint64_t hash, std::uint64_t word) {
+	const std::uint64_t STATE_SECRET = 0xA0761D6478BD642F, WORD_SECRET = 0xE7037ED1A0B428DB;
+
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 product_type;
+
+	product_type product = static_cast<product_type>(hash ^ STATE_SECRET) * (word ^ WORD_SECRET);
+	return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+	hash = (hash ^ STATE_SECRET ^ word) * WORD_SECRET;
+	return hash ^ (hash >> 29);
+#endif
+}
+
+inline std::uint64_t load_word(const char* begin) {
+	std::uint64_t word;
+	__builtin_memcpy(&word, begin, HASH_WORD_SIZE);
+	return word;
+}
+
+inline std::uint64_t load_half_word(const char* begin) {
+	std::uint32_t half_word;
+	__builtin_memcpy(&half_word, begin, sizeof(half_word));
+	return half_word;
+}
+
+/*
+ * Mixes the given count of words from begin on into the hash.
+ */
+inline std::uint64_t hash_words(std::uint64_t hash, const char* begin, std::size_t words) {
+	for (; words != 0; words--, begin += HASH_WORD_SIZE) hash = hash_word(hash, load_word(begin));
+	return hash;
+}
+
+/*
+ * Mixes the bytes in [begin, end) and the size of the whole string into the hash. Less than 8 remaining bytes are loaded by two
+ * overlapping loads, which still determine every byte, because the size is mixed in as well.
+ */
+inline std::uint64_t finish_hash(std::uint64_t hash, const char* begin, const char* end, std::size_t size) {
+	std::size_t words = (end - begin) / HASH_WORD_SIZE;
+	hash = hash_words(hash, begin, words);
+	begin += words * HASH_WORD_SIZE;
+
+	std::size_t rest = end - begin;
+	std::uint64_t word;
+
+	if (rest >= 4) word = (load_half_word(begin) << 32) | load_half_word(end - 4);
+	else if (rest != 0) word = (static_cast<std::uint64_t>(static_cast<unsigned char>(begin[0])) << 16) | (static_cast<std::uint64_t>(static_cast<unsigned char>(begin[rest >> 1])) << 8) | static_cast<unsigned char>(end[-1]);
+	else word = 0;
+
+	return hash_word(hash_word(hash, word), size);
+}
+
+inline std::uint64_t hash_bytes(const char* begin, const char* end) {
+	return finish_hash(0, begin, end, end - begin);
+}
+
+#endif /* HASH_H */
@@ -0,0 +1,74 @@
+#ifndef INCREMENTAL_SCANNER_H
+#define INCREMENTAL_SCANNER_H
+
+#include "scanner.h"
+#include "vector.h"
+
+
+/**
+* IncrementalScanner keeps a source and its tokens in memory, and applies edits to both, as an editor or a watch mode needs them.
+* An edit re-scans from the last token in front of the edited line, because the Scanner was in its start state there, up to the first
+* token behind the edit that starts at the same place it started before. The tokens in between are replaced, the ones behind it only
+* move by the bytes the edit inserted or removed. The tokens are the same a Scanner yields for the whole source.
+**/
+class IncrementalScanner {
+public:
+
+	/*
+	 * The tokens [begin, end) replaced the former tokens [begin, replaced_end).
+	 */
+	struct TokenSpan {
+		std::size_t begin, end, replaced_end;
+
+		TokenSpan(std::size_t begin, std::size_t end, std::size_t replaced_end) : begin(begin), end(end), replaced_end(replaced_end) {}
+	};
+
+private:
+
+	String source;
+	Vector<Token> tokens;
+	Symboltable symboltable;
+	LineIndex line_index;
+
+	std::size_t restart_token(std::uint32_t line_begin) const;
+
+public:
+
+	IncrementalScanner(const char* begin, const char* end);
+
+	IncrementalScanner(const IncrementalScanner& source) = delete;
+	IncrementalScanner& operator=(const IncrementalScanner& source) = delete;
+
+	/*
+	 * Replaces the removed_size bytes at offset by inserted_size bytes from inserted, which must not point into get_source(), and re-scans
+	 * as little as possible. The source and the line index are spliced in place, the lines behind the edit only move.
+	 *
+	 * @return the span of tokens that changed
+	 */
+	TokenSpan edit(std::size_t offset, std::size_t removed_size, const char* inserted, std::size_t inserted_size);
+
+	/*
+	 * The tokens of the whole source, ending in END_OF_FILE. Identical identifiers share their symbol across edits. Their keys refer
+	 * to get_symboltable(), which keeps the pooled literals of replaced tokens as well.
+	 */
+	const Vector<Token>& get_tokens() const {
+		return this->tokens;
+	}
+
+	const String& get_source() const {
+		return this->source;
+	}
+
+	Symboltable& get_symboltable() {
+		return this->symboltable;
+	}
+
+	/*
+	 * Resolves offsets into lines and columns of the current source.
+	 */
+	LineIndex& get_line_index() {
+		return this->line_index;
+	}
+};
+
+#endif /* INCREMENTAL_SCANNER_H */
@@ -0,0 +1,67 @@
+#ifndef LEXEME_H
+#define LEXEME_H
+
+#include <functional>
+#include "string.h"
+#include "hash.h"
+
+
+/**
+* Non-owning view of a lexeme, usually pointing into the Buffer. Lexeme MUST NOT outlive the bytes it refers to!
+**/
+class Lexeme {
+public:
+	typedef const char* const_iterator;
+
+private:
+	const char* begin;
+	std::size_t length;
+
+public:
+	Lexeme(const char* begin, const char* end) : begin(begin), length(end - begin) {}
+	Lexeme(const char* begin, std::size_t length) : begin(begin), length(length) {}
+	Lexeme(const char* string) : Lexeme(string, std::strlen(string)) {}
+	Lexeme(const String& string) : Lexeme(string.cbegin(), string.cend()) {}
+
+	char operator[](std::size_t index) const {
+		return this->begin[index];
+	}
+
+	std::size_t size() const {
+		return this->length;
+	}
+
+	const_iterator cbegin() const {
+		return this->begin;
+	}
+
+	const_iterator cend() const {
+		return this->begin + this->length;
+	}
+};
+
+inline bool operator==(const Lexeme& left, const Lexeme& right) {
+	return left.size() == right.size() && __builtin_memcmp(left.cbegin(), right.cbegin(), left.size()) == 0;
+}
+
+inline bool operator!=(const Lexeme& left, const Lexeme& right) {
+	return !(left == right);
+}
+
+
+namespace std {
+
+	template<> class hash<Lexeme> {
+	public:
+
+		/*
+		 * Calculates a hash 8 bytes per step, just like hash<String>
+		 */
+		std::size_t operator()(const Lexeme& lexeme) const {
+			return hash_bytes(lexeme.cbegin(), lexeme.cend());
+		}
+	};
+
+}
+
+#endif /* LEXEME_H */
@@ -0,0 +1,66 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <cstdint>
+#include <ostream>
+#include "vector.h"
+#include "file_position.h"
+#include "token.h"
+
+class LineIndex;
+
+/*
+ * Prints a token behind its position, like "line:column: TYPE value".
+ */
+struct LocatedToken {
+	DescribedToken token;
+	LineIndex& line_index;
+
+	LocatedToken(const DescribedToken& token, LineIndex& line_index) : token(token), line_index(line_index) {}
+};
+
+std::ostream& operator<<(std::ostream& out, const LocatedToken& located_token);
+
+
+/**
+* LineIndex resolves the byte offsets of tokens into lines and columns, counting "\r\n", "\r" and "\n" as a single line feed each.
+* It records the offset behind every line feed, found by the LINE_BODY SkipKernel, and searches them binary. Bytes that stay in memory
+* are only indexed once the first position is resolved, so scanning never pays for positions unless a diagnostic is printed. Bytes that
+* don't stay in memory, like the chunks read from a pipe, have to be indexed as they arrive.
+**/
+class LineIndex {
+private:
+	Vector<std::uint32_t> line_begins;
+	const char *deferred_begin, *deferred_end;
+	std::size_t indexed_size;
+	bool carriage_return;
+
+	void invalidate(const char* begin, const char* end, std::uint32_t offset);
+
+public:
+	LineIndex() : line_begins(), deferred_begin(nullptr), deferred_end(nullptr), indexed_size(0), carriage_return(false) {}
+
+	/*
+	 * Indexes the next bytes of the source right away.
+	 */
+	void index(const char* begin, const char* end);
+
+	/*
+	 * The next bytes of the source, which outlive the LineIndex, are indexed on demand.
+	 */
+	void defer(const char* begin, const char* end);
+
+	/*
+	 * The removed_size bytes at offset of the source, now [begin, end), were replaced by inserted_size bytes. The line feeds behind
+	 * them only move, so just the inserted bytes are indexed again.
+	 */
+	void splice(const char* begin, const char* end, std::uint32_t offset, std::uint32_t removed_size, std::uint32_t inserted_size);
+
+	FilePosition resolve(std::uint32_t offset);
+
+	LocatedToken locate(const Token& token, const Symboltable& symboltable) {
+		return LocatedToken(token.describe(symboltable), *this);
+	}
+};
+
+#endif /* LINE_INDEX_H */
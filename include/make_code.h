@@ -15,6 +15,7 @@ private:
 
     const ParseTree<Parser::TreeData>* parse_tree;
     std::ostream* code_stream;
+    const Symboltable* symboltable;
 
 
     const Token& get_token(const node_type& node) const;
@@ -61,7 +62,7 @@ private:
 
 public:
 
-    MakeCode(const ParseTree<Parser::TreeData>* parse_tree, std::ostream* code_stream);
+    MakeCode(const ParseTree<Parser::TreeData>* parse_tree, std::ostream* code_stream, const Symboltable* symboltable);
 
     void operator()() const;
 };
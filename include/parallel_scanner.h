@@ -0,0 +1,71 @@
+#ifndef PARALLEL_SCANNER_H
+#define PARALLEL_SCANNER_H
+
+#include "scanner.h"
+#include "vector.h"
+#include "binary_graveyard.h"
+
+
+/**
+* ParallelScanner splits a file behind line feeds into one segment per job and scans the segments concurrently, each by its own Scanner.
+* A segment may begin within a comment, so all segments but the first are scanned from within a comment as well. Stitching the
+* segments from left to right picks the scan matching the state the previous segment ended in, and moves its offsets behind the previous
+* segments. The tokens, their offsets and their symbols are the same a single Scanner yields.
+* The whole file is scanned on construction. A file that can't be mapped into memory is read completely first.
+**/
+class ParallelScanner {
+private:
+	struct Scan;
+	struct Segment;
+
+	typedef BinaryGraveyard<Token>::iterator token_iterator;
+
+	/*
+	 * The tokens of a scan are served as one or two ranges, so they're never copied.
+	 */
+	struct TokenRange {
+		token_iterator begin, end;
+
+		TokenRange(token_iterator begin, token_iterator end) : begin(begin), end(end) {}
+	};
+
+	const static std::size_t MINIMUM_SEGMENT_SIZE = 1 << 16;
+
+	Buffer source;
+	Symboltable* symboltable;
+	Vector<Segment*> segments;
+	Vector<TokenRange> ranges;
+	std::size_t active_range;
+	Token end_of_file;
+
+	void split(const char* begin, const char* end, std::size_t jobs);
+	template<typename Function> void for_each_segment(Function function);
+	static void scan(Scan* scan);
+	static void scan_segment(Segment* segment);
+	void stitch();
+	void relocate(Segment* segment);
+	const Token& scan_token();
+
+public:
+	ParallelScanner(const String& file, std::size_t jobs);
+	~ParallelScanner();
+
+	ParallelScanner(const ParallelScanner& source) = delete;
+	ParallelScanner& operator=(const ParallelScanner& source) = delete;
+
+	/*
+	 * Same as Scanner::next_token() and Scanner::next_tokens(TokenBlock&).
+	 */
+	Token next_token();
+	std::size_t next_tokens(TokenBlock& block);
+
+	LineIndex& get_line_index() {
+		return this->source.get_line_index();
+	}
+
+	Symboltable& get_symboltable() {
+		return *this->symboltable;
+	}
+};
+
+#endif /* PARALLEL_SCANNER_H */
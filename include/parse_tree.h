@@ -92,7 +92,7 @@ public:
         }
 
 
-        Node(const Node&& source) : userdata_storage(), children(std::move(source.children)), parent_node(source.parent_node), storage_type(source.storage_type), data_type(source.data_type) {
+        Node(Node&& source) : userdata_storage(), children(std::move(source.children)), parent_node(source.parent_node), storage_type(source.storage_type), data_type(source.data_type) {
             if(this->storage_type == Node::StorageType::USERDATA) {
                 new (&(this->userdata_storage.userdata)) T(std::move(source.userdata_storage.userdata));
             }
@@ -113,7 +113,7 @@ public:
 
 
         Node& operator=(Node&& source) {
-            Node tmp(source);
+            Node tmp(std::move(source));
             Node* parent = this->parent_node;
 
             swap(*this, tmp);
@@ -134,6 +134,14 @@ public:
         }
 
 
+        /*
+         * Reserves room for count children, so creating them never moves the children created before.
+         */
+        void reserve_children(std::size_t count) {
+            this->children.reserve(count);
+        }
+
+
         Node& parent() {
             return *this->parent_node;
         }
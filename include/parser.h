@@ -5,6 +5,8 @@
 #include "grammar.h"
 #include "finite_state_machine.h"
 #include "parse_tree.h"
+#include "token_block.h"
+#include "line_index.h"
 #include <limits>
 #include <ostream>
 
@@ -55,6 +57,8 @@ private:
     Grammar::Rule::productions_type stack;
     ParseTree<TreeData>::Node* active_node;
     std::ostream* error_stream;
+    LineIndex* line_index;
+    const Symboltable* symboltable;
     bool recovery, valid;
 
 
@@ -82,10 +86,20 @@ private:
 
 public:
 
-    Parser(const Vector<Grammar::Rule>& rules, std::ostream* error_stream);
+    /*
+     * The line_index of the source resolves the positions of unexpected tokens, the symboltable of their scan their values.
+     */
+    Parser(const Vector<Grammar::Rule>& rules, std::ostream* error_stream, LineIndex* line_index, const Symboltable* symboltable);
 
     bool process(const Token& token);
 
+    /*
+     * Processes every token of block in order. DEADBEEF, UNSUPPORTED_CHARACTER and END_OF_FILE tokens aren't part of the grammar and
+     * are skipped by their type alone, reporting them is up to the caller. Every other token is rebuilt from the block, because the
+     * parse tree stores it as a whole, so the parallel arrays only spare the filter from touching payloads and offsets.
+     */
+    bool process(const TokenBlock& block);
+
     bool finalize();
 
     ParseTree<Parser::TreeData>& parse_tree() {
@@ -0,0 +1,53 @@
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+
+/**
+* ReadAhead reads a file descriptor on a background thread into a lock-free single producer, single consumer queue of chunk_count
+* chunks, so the consumer only has to wait for the source if it drains the queue faster than it can be filled. A side finding the
+* queue full or empty spins briefly, then sleeps until the other side moves on.
+**/
+class ReadAhead {
+private:
+	struct Chunk {
+		char* data;
+		std::ptrdiff_t size;
+	};
+
+	int source;
+	std::size_t chunk_count, chunk_size;
+	const static std::size_t SPIN_COUNT = 64;
+
+	Chunk* chunks;
+	std::atomic<std::size_t> produced, consumed;
+	std::atomic<bool> stopped;
+	bool exhausted;
+	std::mutex mutex;
+	std::condition_variable chunk_produced, chunk_consumed;
+	std::thread reader;
+
+	template<typename Predicate> void await(std::condition_variable& condition, Predicate ready);
+	void notify(std::condition_variable& condition);
+	void run();
+
+public:
+	ReadAhead(int source, std::size_t chunk_count, std::size_t chunk_size);
+	~ReadAhead();
+
+	ReadAhead(const ReadAhead& source) = delete;
+	ReadAhead& operator=(const ReadAhead& source) = delete;
+
+	/*
+	 * Copies the next chunk to destination, which must provide room for chunk_size bytes. Returns the amount of bytes copied, 0 at
+	 * the end of the source and -1, if reading the source failed.
+	 */
+	std::ptrdiff_t read(char* destination);
+};
+
+#endif /* READ_AHEAD_H */
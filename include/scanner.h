@@ -2,28 +2,90 @@
 #define SCANNER_H
 
 #include "string.h"
-#include "file_position.h"
+#include "finite_state_machine.h"
+#include "line_index.h"
 #include "symboltable.h"
+#include "lexeme.h"
+#include "token_block.h"
+#include <exception>
 #include "buffer.h"
 
 class Scanner {
 private:
 
-	FilePosition file_position;
-	std::function<void(Direction, char)> line_count_callback;
-	FiniteStateMachine finite_state_machine;
+	FiniteStateMachineCursor cursor;
 	Symboltable symboltable;
 	Buffer buffer;
-	String lexem;
+	std::size_t lexem_size;
+	std::uint32_t lexem_offset;
+	unsigned long integer;
+	std::size_t integer_digits;
+	bool integer_overflow;
+	std::size_t lexem_hash;
+	std::size_t hashed_size;
+	String interrupted_lexem;
 	Token token;
+	std::exception_ptr pending_exception;
 
-	void init_symboltable();
-	Token* make_integer_token(const String& lexem);
+	void skip_blanks();
+	void skip_run(SkipKernel skip_kernel);
+	void skip_loop();
+	void process_run();
+	void reset_integer();
+	void accumulate_integer(const char* begin, const char* end, const char* readable_end);
+	void accumulate_integer();
+	Token* make_integer_token(const Lexeme& lexem);
+	void reset_hash();
+	void accumulate_hash();
+	Token* make_identifier_token(const Lexeme& lexem);
+	void interrupt_lexem(std::size_t invalid_size);
+	bool in_utf8_sequence(std::size_t pending_size) const;
+	const Token& skip_invalid_comment_bytes(std::size_t invalid_size);
+	void enter_comment();
+	const Token& scan_token();
 
 public:
 
-	Scanner(const String& file);
+	/*
+	 * All Scanners share one immutable FiniteStateMachine, so any number of them may run concurrently on different threads.
+	 */
+	Scanner(const String& file, std::size_t read_ahead_chunks = 0);
+
+	/*
+	 * Scans the bytes in [begin, end), which must outlive the Scanner. If in_comment is set, they continue a comment opened in front of
+	 * them. Offsets count from the first of them.
+	 */
+	Scanner(const char* begin, const char* end, bool in_comment = false);
+
+	/*
+	 * Returns END_OF_FILE, located behind the last byte, once the file is exhausted, and keeps returning it on further calls. Non-ASCII bytes outside comments yield an
+	 * UNSUPPORTED_CHARACTER token, the lexem they interrupt continues behind them. So do malformed UTF-8 sequences within comments, but
+	 * they stay part of the comment.
+	 */
 	Token next_token();
+
+	/*
+	 * Fills block with the next tokens and returns their count. The block ends early after an unexpected character, unsupported character
+	 * or end of file token, so the caller can report it in order. An exception raised behind the first token of a block is thrown on the next
+	 * call instead.
+	 */
+	std::size_t next_tokens(TokenBlock& block);
+
+	/*
+	 * Whether the lexem pending at the end of the file is a comment.
+	 */
+	bool in_comment() const;
+
+	Symboltable& get_symboltable() {
+		return this->symboltable;
+	}
+
+	/*
+	 * Resolves the offsets of the tokens into lines and columns.
+	 */
+	LineIndex& get_line_index() {
+		return this->buffer.get_line_index();
+	}
 };
 
 #endif /* SCANNER_H */
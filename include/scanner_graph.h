@@ -0,0 +1,13 @@
+#ifndef SCANNER_GRAPH_H
+#define SCANNER_GRAPH_H
+
+#include "finite_state_machine.h"
+
+/*
+ * Returns the start state of the scanner's State graph. The graph lives in static storage, is built on the first call and is never
+ * modified afterwards. Line and column tracking is up to the Scanner, so the graph carries no callbacks.
+ * Only generate_scanner_tables uses it; the Scanner itself runs on the tables generated from it.
+ */
+const State* scanner_graph();
+
+#endif /* SCANNER_GRAPH_H */
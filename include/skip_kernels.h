@@ -0,0 +1,33 @@
+#ifndef SKIP_KERNELS_H
+#define SKIP_KERNELS_H
+
+#include <cstddef>
+
+
+/**
+* A SkipKernel finds the end of a run of bytes from a fixed set in 16 or 32 byte strides. The FiniteStateMachine assigns one to every
+* state which loops on all bytes of that set, so a caller can consume the whole run at once instead of processing it byte by byte.
+* None of the sets contains bytes above 127, so the FiniteStateMachine validates every byte of a UTF-8 sequence itself. LINE_BODY is the
+* exception, it's no state's loop, but lets the LineIndex find the line feeds of a source.
+**/
+enum class SkipKernel : unsigned char {
+	NONE,
+	BLANK,
+	DIGIT,
+	ALPHA_NUMERIC,
+	COMMENT_BODY,
+	LINE_BODY
+};
+
+/*
+ * Returns whether the set of kernel contains symbol.
+ */
+bool skip_kernel_matches(SkipKernel kernel, unsigned char symbol);
+
+/*
+ * Returns the first position in [begin, end), whose byte isn't contained in the set of kernel, or end. Uses AVX2 if the CPU supports
+ * it, SSE2 otherwise and plain loops on other architectures.
+ */
+const char* skip_run(SkipKernel kernel, const char* begin, const char* end);
+
+#endif /* SKIP_KERNELS_H */
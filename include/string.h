@@ -5,11 +5,16 @@
 //#include <cstring>
 #include <iterator>
 #include "vector.h"
+#include "hash.h"
 
 namespace std {
 std::size_t strlen(const char* source);
 }
 
+/**
+* Strings up to LOCAL_CAPACITY bytes are stored within the String itself and never allocate, like most identifiers, token renderings
+* and labels. Longer ones live on the heap. Either way characters points to the bytes, which are always terminated by '\0'.
+**/
 class String {
 public:
         typedef char value_type;
@@ -19,43 +24,60 @@ public:
         typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
 private:
-	const static std::size_t INITIAL_CAPACITY = 16;
+	const static std::size_t LOCAL_CAPACITY = 15;
 
-	Vector<value_type> string;
+	value_type* characters;
+	std::size_t length;
+	union {
+		std::size_t capacity;
+		value_type local[LOCAL_CAPACITY + 1];
+	};
 
-	explicit String(std::size_t capacity) : string(capacity) {
-		this->string.push_back('\0');
+	explicit String(std::size_t capacity) : characters(this->local), length(0) {
+		this->local[0] = '\0';
+		this->reserve(capacity);
 	}
 
-public:
-	friend void swap(String& left, String& right);
+	bool is_local() const {
+		return this->characters == this->local;
+	}
 
-	String() : String(INITIAL_CAPACITY) {}
+	std::size_t get_capacity() const {
+		return this->is_local() ? String::LOCAL_CAPACITY : this->capacity;
+	}
 
-	String(const String& source) : string(source.string) {}
-	String(const String& source, std::size_t capacity) : string(capacity + 1) {
-		std::size_t offset = (capacity < source.size() ? capacity : source.size());
+	void reserve(std::size_t capacity);
+	void release();
+	void take(String& source);
 
-		Vector<value_type>::const_iterator source_begin = source.cbegin();
-		this->string.insert(this->string.begin(), source_begin, source_begin + offset);
+public:
+	friend void swap(String& left, String& right);
 
-		this->string.push_back('\0');
+	String() : characters(this->local), length(0) {
+		this->local[0] = '\0';
 	}
 
-	String(String&& source) : String(1) {
-		using std::swap;
-		swap(*this, source);
+	String(const String& source) : String(source.cbegin(), source.size()) {}
+	String(const String& source, std::size_t capacity) : String(source.cbegin(), capacity < source.size() ? capacity : source.size()) {}
+
+	String(String&& source) : characters(this->local), length(0) {
+		this->take(source);
 	}
 
-	String(const char* source, std::size_t bytes) : string(bytes + 1) {
-	    this->string.insert(this->string.end(), source, source + bytes);
-	    this->string.push_back('\0');
+	String(const char* source, std::size_t bytes) : String(bytes) {
+		__builtin_memcpy(this->characters, source, bytes);
+		this->length = bytes;
+		this->characters[bytes] = '\0';
 	}
 
 	String(const char* source) : String(source, std::strlen(source)) {}
 
 	String(const_iterator begin, const_iterator end) : String(begin, std::distance(begin, end)) {}
 
+	~String() {
+		this->release();
+	}
+
 	String& operator=(String source) {
 		swap(*this, source);
 		return *this;
@@ -68,41 +90,43 @@ public:
 
 	String& operator+=(const String& source);
 	String& operator+=(value_type source);
+	String& append(const_iterator begin, const_iterator end);
+	String& replace(std::size_t offset, std::size_t removed_size, const_iterator begin, const_iterator end);
 
 	const value_type& operator[](std::size_t index) const {
-		return this->string[index];
+		return this->characters[index];
 	}
 
 	value_type& operator[](std::size_t index) {
-		return this->string[index];
+		return this->characters[index];
 	}
 
 	const_iterator c_str() const {
-		return &this->operator[](0);
+		return this->characters;
 	}
 
 	iterator c_str() {
-		return &this->operator[](0);
+		return this->characters;
 	}
 
 	std::size_t size() const {
-		return this->string.size() - 1;
+		return this->length;
 	}
 
 	iterator begin() {
-		return this->string.begin();
+		return this->characters;
 	}
 
 	iterator end() {
-		return this->string.end() - 1;
+		return this->characters + this->length;
 	}
 
 	const_iterator cbegin() const {
-		return this->string.cbegin();
+		return this->characters;
 	}
 
 	const_iterator cend() const {
-		return this->string.cend() - 1;
+		return this->characters + this->length;
 	}
 
 	reverse_iterator rbegin() {
@@ -124,8 +148,8 @@ public:
 	const_iterator find_last_of(const char* sequence) const;
 
 	String& clear() {
-		this->string.clear();
-		this->string.push_back('\0');
+		this->length = 0;
+		this->characters[0] = '\0';
 		return *this;
 	}
 };
@@ -144,15 +168,10 @@ namespace std {
     public:
 
         /*
-        * Calculates a hash with the SDBM hash function algorithm
+        * Calculates a hash 8 bytes per step, see hash.h
         */
         std::size_t operator()(const String& string) const {
-            std::size_t hash = 0;
-            for (String::const_iterator iterator = string.cbegin(), end = string.cend(); iterator != end; ++iterator) {
-                hash = *iterator + (hash << 6) + (hash << 16) - hash;
-            }
-
-            return hash;
+            return hash_bytes(string.cbegin(), string.cend());
         }
 	};
 
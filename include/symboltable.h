@@ -2,66 +2,192 @@
 #define SYMBOLTABLE_H
 
 #include "string.h"
-#include "unordered_map.h"
+#include "lexeme.h"
 #include "binary_graveyard.h"
+#include "vector.h"
+#include "information.h"
+#include <cstdint>
 #include <functional>
 //#include <cstring>
 
+/**
+* Symboltable numbers its symbols in the order they're inserted, so a token refers to its symbol by a 32 bit key. It also keeps the
+* integer literals too large for a key, so an integer token refers to its value by a key as well.
+*
+* Lexems are interned by open addressing in a single array of Slots, which caches the hash, the size and the first bytes of every
+* lexem, and points to all of its bytes within the String behind its key, the only copy of them. So a lookup usually touches a single
+* Slot, and the String only for lexems longer than a Slot's prefix. The Strings never move, they are buried in a BinaryGraveyard.
+**/
 class Symboltable {
 public:
 
-	typedef Information* key_type;
+	typedef std::uint32_t key_type;
+
+	const static key_type UNKNOWN_KEY = UINT32_MAX;
+
+	/*
+	 * The key of an integer below POOLED_LITERAL is the integer itself, the key of a larger one is its index into the literals, marked
+	 * by POOLED_LITERAL.
+	 */
+	const static key_type POOLED_LITERAL = 0x80000000;
 
 private:
 
-	class StringHash {
-		private:
-			std::hash<String> hash;
-
-		public:
-			/*
-			 * Calculates a hash with the SDBM hash function algorithm
-			 */
-			std::size_t operator()(const String* string) const {
-				return this->hash(*string);
-			}
-	};
+	const static std::size_t INITIAL_CAPACITY = 128;
+	const static std::size_t PREFIX_SIZE = 12;
+
+	/*
+	 * A Slot is empty, if its key is UNKNOWN_KEY. Two of them share a cache line, so a Slot only keeps the low half of the hash, which
+	 * picks the Slot of any table below 2^32 Slots.
+	 */
+	struct Slot {
+		const char* lexem;
+		std::uint32_t hash;
+		std::uint32_t size;
+		key_type key;
+		char prefix[PREFIX_SIZE];
 
-	class StringCompare {
-		public:
-			bool operator() (const String* left, const String* right) const {
-				return *left == *right;
-			}
+		Slot() : lexem(nullptr), hash(0), size(0), key(Symboltable::UNKNOWN_KEY), prefix() {}
 	};
 
-	UnorderedMap<String*, Information*, Symboltable::StringHash, Symboltable::StringCompare> map;
+	Vector<Slot> slots;
+	std::size_t slot_mask;
 	BinaryGraveyard<String> keys;
 	BinaryGraveyard<Information> values;
-	
+	Vector<Information*> symbols;
+	Vector<long> literals;
+
+	/*
+	 * The hashes are avalanched, so their low bits pick the Slot directly.
+	 */
+	static std::size_t home_slot(std::uint32_t hash, std::size_t slot_mask) {
+		return static_cast<std::size_t>(hash) & slot_mask;
+	}
+
+	static bool matches(const Slot& slot, const Lexeme& lexem, std::uint32_t hash) {
+		std::size_t size = lexem.size();
+		if (slot.hash != hash || slot.size != size) return false;
+		if (size <= Symboltable::PREFIX_SIZE) return __builtin_memcmp(slot.prefix, lexem.cbegin(), size) == 0;
+
+		return __builtin_memcmp(slot.prefix, lexem.cbegin(), Symboltable::PREFIX_SIZE) == 0
+			&& __builtin_memcmp(slot.lexem + Symboltable::PREFIX_SIZE, lexem.cbegin() + Symboltable::PREFIX_SIZE, size - Symboltable::PREFIX_SIZE) == 0;
+	}
+
+	/*
+	 * Returns the Slot holding lexem, or the empty Slot ending its probe sequence.
+	 */
+	std::size_t find_slot(const Lexeme& lexem, std::uint32_t hash) const {
+		std::size_t index = Symboltable::home_slot(hash, this->slot_mask);
+
+		while (true) {
+			const Slot& slot = this->slots[index];
+			if (slot.key == Symboltable::UNKNOWN_KEY || Symboltable::matches(slot, lexem, hash)) return index;
+
+			index = (index + 1) & this->slot_mask;
+		}
+	}
+
+	/*
+	 * Doubles the Slots once half of them are taken. The cached hashes place the Slots again, without touching any lexem.
+	 */
+	void grow() {
+		std::size_t slot_mask = (this->slot_mask << 1) | 1;
+		Vector<Slot> slots(slot_mask + 1, Slot());
+
+		for (Vector<Slot>::const_iterator slot = this->slots.cbegin(), end = this->slots.cend(); slot != end; ++slot) {
+			if ((*slot).key == Symboltable::UNKNOWN_KEY) continue;
+
+			std::size_t index = Symboltable::home_slot((*slot).hash, slot_mask);
+			while (slots[index].key != Symboltable::UNKNOWN_KEY) index = (index + 1) & slot_mask;
+
+			slots[index] = *slot;
+		}
+
+		swap(this->slots, slots);
+		this->slot_mask = slot_mask;
+	}
+
 public:
 
+	Symboltable() : slots(Symboltable::INITIAL_CAPACITY, Slot()), slot_mask(Symboltable::INITIAL_CAPACITY - 1), keys(), values(), symbols(), literals() {}
+
 	/*
-	 * Inserts a given lexem to the symbol table and returns the key of it.
+	 * Inserts a given lexem to the symbol table and returns the key of it. Any byte span of the Buffer or a String is a Lexeme, so a
+	 * known lexem is found without any allocation, and the lexem is only copied into a String, if it isn't known yet.
 	 *
 	 * @param lexem the lexem to be inserted
 	 * @param token_type the TokenType to be associated with the lexem
 	 * @return returns the key to the inserted lexem
 	 */
-	key_type insert(const String& lexem, TokenType token_type = TokenType::IDENTIFIER) {
-		UnorderedMap<String*, Information*>::iterator iterator = this->map.find(&lexem);
+	key_type insert(const Lexeme& lexem, TokenType token_type) {
+		return this->insert(lexem, std::hash<Lexeme>()(lexem), token_type);
+	}
+
+	/*
+	 * Like insert(const Lexeme&, TokenType), but hash must be std::hash<Lexeme> of lexem, which the Scanner computes while consuming
+	 * the lexem.
+	 */
+	key_type insert(const Lexeme& lexem, std::size_t hash, TokenType token_type) {
+		std::size_t index = this->find_slot(lexem, static_cast<std::uint32_t>(hash));
+		if (this->slots[index].key != Symboltable::UNKNOWN_KEY) return this->slots[index].key;
 
-		if (iterator == this->map.end()) {
-			String* key = &keys.bury(lexem);
-			Information* value = &values.bury(Information(key, token_type));
+		key_type key = static_cast<key_type>(this->symbols.size());
+		String* string = &keys.emplace(lexem.cbegin(), lexem.size());
+		this->symbols.push_back(&values.emplace(string, token_type));
 
-			return (*this->map.force_insert(key, value, iterator)).second;
-		}
+		Slot& slot = this->slots[index];
+		slot.lexem = string->cbegin();
+		slot.hash = static_cast<std::uint32_t>(hash);
+		slot.size = static_cast<std::uint32_t>(lexem.size());
+		slot.key = key;
+		__builtin_memcpy(slot.prefix, lexem.cbegin(), std::min(lexem.size(), static_cast<std::size_t>(Symboltable::PREFIX_SIZE)));
 
-		return (*iterator).second;
+		if (this->symbols.size() * 2 > this->slots.size()) this->grow();
+		return key;
 	}
 
 	Information* lookup(key_type key) const {
-		return key;
+		return this->symbols[key];
+	}
+
+	/*
+	 * Returns the key of a known lexem, or UNKNOWN_KEY. Never modifies the table, so any number of threads may look up concurrently.
+	 */
+	key_type lookup(const Lexeme& lexem) const {
+		return this->lookup(lexem, std::hash<Lexeme>()(lexem));
+	}
+
+	/*
+	 * Like lookup(const Lexeme&), but hash must be std::hash<Lexeme> of lexem.
+	 */
+	key_type lookup(const Lexeme& lexem, std::size_t hash) const {
+		return this->slots[this->find_slot(lexem, static_cast<std::uint32_t>(hash))].key;
+	}
+
+	/*
+	 * Returns the key of a non-negative integer literal. Equal literals too large for a key aren't merged, every one is kept.
+	 */
+	key_type insert_literal(long literal) {
+		if (literal < static_cast<long>(Symboltable::POOLED_LITERAL)) return static_cast<key_type>(literal);
+
+		this->literals.push_back(literal);
+		return static_cast<key_type>(this->literals.size() - 1) | Symboltable::POOLED_LITERAL;
+	}
+
+	long lookup_literal(key_type key) const {
+		return (key & Symboltable::POOLED_LITERAL) ? this->literals[key & ~Symboltable::POOLED_LITERAL] : static_cast<long>(key);
+	}
+
+	std::size_t pooled_literals() const {
+		return this->literals.size();
+	}
+
+	BinaryGraveyard<Information>::iterator begin() {
+		return this->values.begin();
+	}
+
+	BinaryGraveyard<Information>::iterator end() {
+		return this->values.end();
 	}
 };
 
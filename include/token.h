@@ -2,7 +2,10 @@
 #define TOKEN_H
 
 #include "information.h"
+#include "symboltable.h"
 #include "string.h"
+#include <cstdint>
+#include <ostream>
 
 enum class TokenType : unsigned char {
     DEADBEEF,
@@ -42,57 +45,95 @@ enum class TokenType : unsigned char {
     COMMENT,
     LINE_FEED,
 
+    UNSUPPORTED_CHARACTER,
+    END_OF_FILE,
+
     EPSILON,
 
     ENUM_ENTRY_COUNT
 };
 
+struct DescribedToken;
+
+/*
+ * A token only knows the byte offset of its first byte in the source, a LineIndex resolves it into a line and a column on demand.
+ * Sources are limited to 4 GiB therefore. Identifiers and integers only carry a key into the Symboltable of their scan, which resolves
+ * their Information and value, so a token takes 12 bytes.
+ */
 class Token {
 public:
 	union {
-		Information* information;
-		long integer;
+		Symboltable::key_type symbol;
+		Symboltable::key_type literal;
 		char error_char;
 	} value;
-	std::size_t line, column;
+	std::uint32_t offset;
 	TokenType token_type;
 
-	Token() : line(0), column(0), token_type(TokenType::DEADBEEF) {
-		this->value.information = nullptr;
+	Token() : offset(0), token_type(TokenType::DEADBEEF) {
+		this->value.symbol = 0;
 	}
 
-	Token(std::size_t line, std::size_t column, char error_char) : line(line), column(column), token_type(TokenType::DEADBEEF) {
+	Token(std::uint32_t offset, char error_char, TokenType token_type = TokenType::DEADBEEF) : offset(offset), token_type(token_type) {
+		this->value.symbol = 0;
 		this->value.error_char = error_char;
 	}
 
-	Token(std::size_t line, std::size_t column, long integer) : line(line), column(column), token_type(TokenType::INTEGER) {
-		this->value.integer = integer;
-	}
-
-	Token(std::size_t line, std::size_t column, TokenType token_type, Information* information) : line(line), column(column), token_type(token_type) {
-		this->value.information = information;
+	/*
+	 * The key is a symbol for IDENTIFIER and OUT_OF_RANGE_INTEGER, and a literal for INTEGER.
+	 */
+	Token(std::uint32_t offset, TokenType token_type, Symboltable::key_type key) : offset(offset), token_type(token_type) {
+		this->value.symbol = key;
 	}
 
-	Token(std::size_t line, std::size_t column, TokenType token_type) : line(line), column(column), token_type(token_type) {
-		this->value.information = nullptr;
+	Token(std::uint32_t offset, TokenType token_type) : offset(offset), token_type(token_type) {
+		this->value.symbol = 0;
 	}
 
 	TokenType get_token_type() const {
 	    return this->token_type;
 	}
 
-	FundamentalType get_data_type() const {
-	    return this->value.information->data_type;
+	Information* get_information(const Symboltable& symboltable) const {
+	    return symboltable.lookup(this->value.symbol);
+	}
+
+	const String& get_lexem(const Symboltable& symboltable) const {
+	    return *symboltable.lookup(this->value.symbol)->lexem;
+	}
+
+	long get_integer(const Symboltable& symboltable) const {
+	    return symboltable.lookup_literal(this->value.literal);
 	}
 
-	void set_data_type(FundamentalType data_type) {
-	    this->value.information->data_type = data_type;
+	FundamentalType get_data_type(const Symboltable& symboltable) const {
+	    return symboltable.lookup(this->value.symbol)->data_type;
 	}
 
-	String to_string() const;
+	void set_data_type(const Symboltable& symboltable, FundamentalType data_type) const {
+	    symboltable.lookup(this->value.symbol)->data_type = data_type;
+	}
+
+	String to_string(const Symboltable& symboltable) const;
+
+	DescribedToken describe(const Symboltable& symboltable) const;
 };
 
+/*
+ * Prints the type and the value of a token, LineIndex::locate(const Token&, const Symboltable&) prints its position in front of them.
+ */
+struct DescribedToken {
+	const Token& token;
+	const Symboltable& symboltable;
+
+	DescribedToken(const Token& token, const Symboltable& symboltable) : token(token), symboltable(symboltable) {}
+};
+
+inline DescribedToken Token::describe(const Symboltable& symboltable) const {
+	return DescribedToken(*this, symboltable);
+}
+
 std::ostream& operator<<(std::ostream& out, TokenType token_type);
-std::ostream& operator<<(std::ostream& out, const Token& token);
+std::ostream& operator<<(std::ostream& out, const DescribedToken& described_token);
 
 #endif /* TOKEN_H */
@@ -0,0 +1,63 @@
+#ifndef TOKEN_BLOCK_H
+#define TOKEN_BLOCK_H
+
+#include "token.h"
+
+
+/**
+* A fixed capacity batch of tokens, stored as parallel arrays of types, payloads and positions, so consumers which mostly look at the
+* token types walk contiguous memory. Filled by Scanner::next_tokens() and consumed by Parser::process(const TokenBlock&).
+**/
+class TokenBlock {
+public:
+	typedef decltype(Token::value) payload_type;
+
+	const static std::size_t CAPACITY = 256;
+
+private:
+	TokenType types[CAPACITY];
+	payload_type payloads[CAPACITY];
+	std::uint32_t offsets[CAPACITY];
+	std::size_t count;
+
+public:
+	TokenBlock() : count(0) {}
+
+	TokenBlock(const TokenBlock& source) = delete;
+	TokenBlock& operator=(const TokenBlock& source) = delete;
+
+	std::size_t size() const {
+		return this->count;
+	}
+
+	bool full() const {
+		return this->count == TokenBlock::CAPACITY;
+	}
+
+	void clear() {
+		this->count = 0;
+	}
+
+	void push_back(const Token& token) {
+		this->types[this->count] = token.token_type;
+		this->payloads[this->count] = token.value;
+		this->offsets[this->count] = token.offset;
+		this->count++;
+	}
+
+	const TokenType* token_types() const {
+		return this->types;
+	}
+
+	TokenType token_type(std::size_t index) const {
+		return this->types[index];
+	}
+
+	Token token(std::size_t index) const {
+		Token token(this->offsets[index], this->types[index]);
+		token.value = this->payloads[index];
+		return token;
+	}
+};
+
+#endif /* TOKEN_BLOCK_H */
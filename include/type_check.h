@@ -4,6 +4,7 @@
 #include "token.h"
 #include "parse_tree.h"
 #include "parser.h"
+#include "line_index.h"
 #include "string.h"
 #include "unordered_map.h"
 #include <ostream>
@@ -24,6 +25,8 @@ private:
     ParseTree<Parser::TreeData>* parse_tree;
     UnorderedMap<const String*, const node_type*> identifier_dictionary;
     std::ostream* error_stream;
+    LineIndex* line_index;
+    const Symboltable* symboltable;
     bool valid;
 
 
@@ -79,7 +82,7 @@ private:
 
 public:
 
-    TypeCheck(ParseTree<Parser::TreeData>* parse_tree, std::ostream* error_stream);
+    TypeCheck(ParseTree<Parser::TreeData>* parse_tree, std::ostream* error_stream, LineIndex* line_index, const Symboltable* symboltable);
 
     bool operator()();
 };
@@ -122,7 +122,11 @@ private:
 	std::size_t entry_count, maximum_load;
 
 	std::size_t bucket_index(const const_key_type& key) const {
-		return this->hash(key) % this->capacity();
+		return this->bucket_index_of_hash(this->hash(key));
+	}
+
+	std::size_t bucket_index_of_hash(std::size_t hash) const {
+		return hash % this->capacity();
 	}
 
 	typename Vector<entry_type>::const_iterator find_entry(const Vector<entry_type>& values, const const_key_type& key) const {
@@ -229,20 +233,39 @@ public:
 	}
 
 	iterator force_insert(const key_type& key, const value_type& value, iterator hint) {
+		return this->force_insert(key, this->hash(key), value, hint);
+	}
+
+	/*
+	 * Like force_insert(const key_type&, const value_type&, iterator), but hash must be the hash of key.
+	 */
+	iterator force_insert(const key_type& key, std::size_t hash, const value_type& value, iterator hint) {
 		typename Vector<entry_type>::iterator iterator = this->force_insert(key, value, hint.bucket_iterator);
 
-		return UnorderedMapIterator<entry_type>(hint.bucket_iterator, iterator, this->end_iterator());
+		// The hint's bucket is gone, if the insertion resized the buckets
+		return UnorderedMapIterator<entry_type>(this->buckets.begin() + this->bucket_index_of_hash(hash), iterator, this->end_iterator());
 	}
 
 	iterator find(const const_key_type& key) {
-		Vector<entry_type>& values = this->buckets[this->bucket_index(key)];
+		return this->find(key, this->hash(key));
+	}
+
+	const_iterator find(const const_key_type& key) const {
+		return this->find(key, this->hash(key));
+	}
+
+	/*
+	 * Finds key by its hash, which the caller computed already.
+	 */
+	iterator find(const const_key_type& key, std::size_t hash) {
+		Vector<entry_type>& values = this->buckets[this->bucket_index_of_hash(hash)];
 		typename Vector<entry_type>::iterator iterator = this->find_entry(values, key);
 
 		return UnorderedMapIterator<entry_type>(&values, iterator, this->end_iterator(), true);
 	}
 
-	const_iterator find(const const_key_type& key) const {
-		const Vector<entry_type>& values = this->buckets[this->bucket_index(key)];
+	const_iterator find(const const_key_type& key, std::size_t hash) const {
+		const Vector<entry_type>& values = this->buckets[this->bucket_index_of_hash(hash)];
 		typename Vector<entry_type>::const_iterator iterator = this->find_entry(values, key);
 
 		return UnorderedMapIterator<const entry_type>(&values, iterator, this->end_iterator(), true);
@@ -7,9 +7,17 @@
 #include <algorithm>
 #include <type_traits>
 #include <memory>
+#include <new>
 
 template<typename T> class Vector;
 
+/*
+ * Whether a T may be moved to another address by copying its bytes, leaving the source behind without destroying it. Holds for trivially
+ * copyable types, specialize it for types without pointers into themselves, like Vector.
+ */
+template<typename T> struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+template<typename T> struct is_trivially_relocatable<Vector<T>> : std::true_type {};
+
 template<typename T> void swap(Vector<T>& left, Vector<T>& right) {
 	using std::swap;
 	swap(left.objects, right.objects);
@@ -17,6 +25,10 @@ template<typename T> void swap(Vector<T>& left, Vector<T>& right) {
 	swap(left.end_free_space, right.end_free_space);
 }
 
+/**
+* A default constructed Vector allocates nothing, its first growth reserves INITIAL_CAPACITY objects. Growth doubles the capacity and
+* relocates the objects: trivially relocatable ones by realloc(), all others by moving them.
+**/
 template<typename T>
 class Vector {
 public:
@@ -28,26 +40,58 @@ public:
         typedef std::ptrdiff_t difference_type;
 
 private:
-	const static std::size_t INITIAL_CAPACITY = 16;
-	const static double RESIZE_FACTOR;
+	const static std::size_t INITIAL_CAPACITY = 4;
 
 	value_type *objects, *next_free_space, *end_free_space;
 
-	void resize() {
-		resize(static_cast<std::size_t>((this->end_free_space - this->objects) * RESIZE_FACTOR));
+	static value_type* allocate(std::size_t capacity) {
+		if (capacity == 0) return nullptr;
+
+		void* objects = std::malloc(sizeof(value_type) * capacity);
+		if (objects == nullptr) throw std::bad_alloc();
+
+		return static_cast<value_type*>(objects);
+	}
+
+	template<typename U = value_type> typename std::enable_if<is_trivially_relocatable<U>::value>::type relocate(std::size_t new_capacity) {
+		std::size_t size = this->size();
+		void* objects = new_capacity == 0 ? nullptr : std::realloc(static_cast<void*>(this->objects), sizeof(value_type) * new_capacity);
+
+		if (new_capacity == 0) std::free(this->objects);
+		else if (objects == nullptr) throw std::bad_alloc();
+
+		this->objects = static_cast<value_type*>(objects);
+		this->next_free_space = this->objects + size;
+		this->end_free_space = this->objects + new_capacity;
 	}
 
-	void resize(std::size_t new_capacity) {
-		Vector<T> tmp(std::make_move_iterator(this->begin()), std::make_move_iterator(this->end()), new_capacity);
+	template<typename U = value_type> typename std::enable_if<!is_trivially_relocatable<U>::value>::type relocate(std::size_t new_capacity) {
+		Vector<T> tmp(new_capacity);
+		tmp.next_free_space = std::uninitialized_copy(std::make_move_iterator(this->begin()), std::make_move_iterator(this->end()), tmp.begin());
 		swap(*this, tmp);
 	}
 
+	/*
+	 * Makes room for required_space more objects, at least doubling the capacity.
+	 */
 	void resize_on_demand(std::size_t required_space) {
 		if (this->free_capacity() < required_space) {
-			this->resize((this->size() + required_space) * RESIZE_FACTOR);
+			std::size_t new_capacity = std::max(this->capacity() * 2, this->size() + required_space);
+			this->relocate(std::max(new_capacity, Vector::INITIAL_CAPACITY));
 		}
 	}
 
+	/*
+	 * Constructs the object from args before growing, because args may refer to objects of this Vector.
+	 */
+	template<typename... Args> void grow_and_emplace_back(Args&&... args) {
+		value_type object(std::forward<Args>(args)...);
+
+		this->resize_on_demand(1);
+		new (static_cast<void*>(this->next_free_space)) value_type(std::move(object));
+		++this->next_free_space;
+	}
+
 	template<typename U = value_type> typename std::enable_if<std::is_trivially_destructible<U>::value>::type destruct() {}
 	template<typename U = value_type> typename std::enable_if<!std::is_trivially_destructible<U>::value>::type destruct() {
 		for (reverse_iterator iterator = this->rbegin(), end = this->rend(); iterator != end; ++iterator) {
@@ -64,24 +108,26 @@ public:
 
 	const static Vector<value_type> EMPTY;
 
-	explicit Vector(std::size_t capacity = INITIAL_CAPACITY) {
-		this->next_free_space = this->objects = static_cast<value_type*>(::operator new[](sizeof(value_type) * capacity));
+	Vector() : objects(nullptr), next_free_space(nullptr), end_free_space(nullptr) {}
+
+	explicit Vector(std::size_t capacity) {
+		this->next_free_space = this->objects = Vector::allocate(capacity);
 		this->end_free_space = this->objects + capacity;
 	}
 
 	Vector(std::size_t size, const value_type& default_value) : Vector(size) {
-		for (size_t index = 0; index < size; index++) this->push_back(default_value);
+		for (; this->next_free_space != this->end_free_space; ++this->next_free_space) new (static_cast<void*>(this->next_free_space)) value_type(default_value);
 	}
 
 	Vector(std::initializer_list<value_type> initializer) : Vector(initializer.begin(), initializer.end()) {}
 
-	template<typename InputIterator> Vector(InputIterator begin, InputIterator end) : Vector(begin, end, std::abs(std::distance(begin, end)) * RESIZE_FACTOR) {}
+	template<typename InputIterator> Vector(InputIterator begin, InputIterator end) : Vector(begin, end, std::abs(std::distance(begin, end))) {}
 
 	template<typename InputIterator> Vector(InputIterator begin, InputIterator end, std::size_t capacity) : Vector(capacity) {
 		this->next_free_space = std::uninitialized_copy(begin, end, this->begin());
 	}
 
-	Vector(const Vector<value_type>& source) : Vector(source.cbegin(), source.cend(), source.capacity()) {}
+	Vector(const Vector<value_type>& source) : Vector(source.cbegin(), source.cend(), source.size()) {}
 	Vector(Vector<value_type>&& source) : objects(nullptr), next_free_space(nullptr), end_free_space(nullptr) {
 		swap(*this, source);
 	}
@@ -135,6 +181,9 @@ public:
 		return this->objects[index];
 	}
 
+	/*
+	 * The inserted range must not be part of this Vector.
+	 */
 	template<typename InputIterator> iterator insert(iterator target, InputIterator begin, InputIterator end) {
 		std::size_t element_count = std::abs(std::distance(begin, end));
 		difference_type offset = std::distance(this->begin(), target);
@@ -142,14 +191,19 @@ public:
 		this->resize_on_demand(element_count);
 		target = this->begin() + offset;
 
+		if (target == this->end()) {
+			this->next_free_space = std::uninitialized_copy(begin, end, target);
+			return target;
+		}
+
 		iterator copy_begin = target;
 		iterator copy_end = copy_begin + (this->end() - target - element_count);
 		iterator uninitialized_copy_begin = (this->end() - element_count < target) ? target : this->end() - element_count;
 		iterator uninitialized_copy_end = this->end();
 
-		std::uninitialized_copy(uninitialized_copy_begin, uninitialized_copy_end, this->end() + (element_count - std::distance(uninitialized_copy_begin, uninitialized_copy_end)));
+		std::uninitialized_copy(std::make_move_iterator(uninitialized_copy_begin), std::make_move_iterator(uninitialized_copy_end), this->end() + (element_count - std::distance(uninitialized_copy_begin, uninitialized_copy_end)));
 		if (copy_begin <= copy_end) {
-			std::copy_backward(copy_begin, copy_end, this->end());
+			std::move_backward(copy_begin, copy_end, this->end());
 			std::copy(begin, end, target);
 		}
 		else {
@@ -180,22 +234,34 @@ public:
 		return this->end_free_space - this->next_free_space;
 	}
 
+	/*
+	 * Reserves room for capacity objects in total, without ever shrinking.
+	 */
+	void reserve(std::size_t capacity) {
+		if (capacity > this->capacity()) this->relocate(capacity);
+	}
+
+	/*
+	 * Releases the capacity not taken by any object.
+	 */
+	void shrink_to_fit() {
+		if (this->free_capacity() != 0) this->relocate(this->size());
+	}
+
 	void push_back(const value_type& object) {
-		this->resize_on_demand(1);
-		new (static_cast<void*>(&*this->end())) value_type(object);
-		++this->next_free_space;
+		this->emplace_back(object);
 	}
 
 	void push_back(value_type&& object) {
-		this->resize_on_demand(1);
-		new (static_cast<void*>(&*this->end())) value_type(object);
-		++this->next_free_space;
+		this->emplace_back(std::move(object));
 	}
 
 	template<typename... Args> void emplace_back(Args&&... args) {
-		this->resize_on_demand(1);
-		new (static_cast<void*>(&*this->end())) value_type(std::forward<Args>(args)...);
-		++this->next_free_space;
+		if (this->free_capacity() == 0) this->grow_and_emplace_back(std::forward<Args>(args)...);
+		else {
+			new (static_cast<void*>(this->next_free_space)) value_type(std::forward<Args>(args)...);
+			++this->next_free_space;
+		}
 	}
 
 	template<typename U = value_type> typename std::enable_if<std::is_trivially_destructible<U>::value, value_type>::type pop_back() {
@@ -245,12 +311,12 @@ public:
 
 	~Vector() {
 		this->destruct();
-		::operator delete[](this->objects);
+		std::free(this->objects);
 	}
 
 };
 
-template<typename T> const double Vector<T>::RESIZE_FACTOR = 1.4;
+template<typename T> const std::size_t Vector<T>::INITIAL_CAPACITY;
 template<typename T> const Vector<T> Vector<T>::EMPTY(0);
 
 #endif /* VECTOR_H */
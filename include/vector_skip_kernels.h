@@ -0,0 +1,62 @@
+#ifndef VECTOR_SKIP_KERNELS_H
+#define VECTOR_SKIP_KERNELS_H
+
+#include "skip_kernels.h"
+
+
+/**
+* The SkipKernels written once against the small set of operations every instruction set provides as Isa:
+* load(), set(), equal(), either(), in_range() (unsigned, inclusive) and mask(), which gathers the top bit of every byte lane.
+* Each instruction set is instantiated in its own translation unit, so it can be compiled with the matching flags. The bytes behind the
+* last whole vector are tested one at a time in the first lane, so nothing is ever read past end.
+**/
+template<typename Isa> class VectorSkipKernels {
+private:
+	typedef typename Isa::vector vector;
+
+	static unsigned int blank(vector symbols) {
+		return Isa::mask(Isa::either(Isa::equal(symbols, Isa::set(' ')), Isa::equal(symbols, Isa::set('\t'))));
+	}
+
+	static unsigned int digit(vector symbols) {
+		return Isa::mask(Isa::in_range(symbols, '0', '9'));
+	}
+
+	static unsigned int alpha_numeric(vector symbols) {
+		vector lower_case = Isa::either(symbols, Isa::set(0x20));
+		return Isa::mask(Isa::either(Isa::in_range(symbols, '0', '9'), Isa::in_range(lower_case, 'a', 'z')));
+	}
+
+	static unsigned int comment_body(vector symbols) {
+		vector stops = Isa::either(Isa::equal(symbols, Isa::set('*')), Isa::either(Isa::equal(symbols, Isa::set('\r')), Isa::equal(symbols, Isa::set('\n'))));
+		return ~(Isa::mask(stops) | Isa::mask(symbols)) & Isa::FULL_MASK;
+	}
+
+	static unsigned int line_body(vector symbols) {
+		return ~Isa::mask(Isa::either(Isa::equal(symbols, Isa::set('\r')), Isa::equal(symbols, Isa::set('\n')))) & Isa::FULL_MASK;
+	}
+
+	template<unsigned int (*matches)(vector)> static const char* skip(const char* begin, const char* end) {
+		while (static_cast<std::size_t>(end - begin) >= Isa::WIDTH) {
+			unsigned int stops = ~matches(Isa::load(begin)) & Isa::FULL_MASK;
+			if (stops) return begin + __builtin_ctz(stops);
+			begin += Isa::WIDTH;
+		}
+		while (begin != end && (matches(Isa::set(*begin)) & 1)) begin++;
+		return begin;
+	}
+
+public:
+	static const char* skip(SkipKernel kernel, const char* begin, const char* end) {
+		switch(kernel) {
+		case SkipKernel::BLANK: return VectorSkipKernels::skip<VectorSkipKernels::blank>(begin, end);
+		case SkipKernel::DIGIT: return VectorSkipKernels::skip<VectorSkipKernels::digit>(begin, end);
+		case SkipKernel::ALPHA_NUMERIC: return VectorSkipKernels::skip<VectorSkipKernels::alpha_numeric>(begin, end);
+		case SkipKernel::COMMENT_BODY: return VectorSkipKernels::skip<VectorSkipKernels::comment_body>(begin, end);
+		case SkipKernel::LINE_BODY: return VectorSkipKernels::skip<VectorSkipKernels::line_body>(begin, end);
+		default: return begin;
+		}
+	}
+};
+
+#endif /* VECTOR_SKIP_KERNELS_H */
@@ -1,97 +1,157 @@
 #include "buffer.h"
 #include "exception.h"
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-Buffer::Buffer(const String& file, std::size_t buffer_size) : source(file.c_str()) {
-	this->back_buffer_begin = this->back_buffer_end = static_cast<char*>(::operator new[](buffer_size << 1));
-	this->begin = this->end = this->next = this->back_buffer_begin + buffer_size;
-	this->next_chunk_loaded = this->previous_chunk_loaded = false;
-	this->buffer_size = buffer_size;
+Buffer::Buffer(const String& file, std::size_t lookback, std::size_t read_ahead_chunks, std::size_t buffer_size)
+	: origin(0), line_index(), mapping(nullptr), mapping_size(0), source(-1), window(nullptr), window_size(0), read_ahead(nullptr) {
+	this->begin = this->end = this->next = this->marker = nullptr;
 	this->injected_newline = false;
-	this->seek_double_buffer_size = false;
+	this->lookback = lookback;
+	this->buffer_size = buffer_size;
 
-	if (!(this->source.is_open())) {
+	bool standard_input = file == String(Buffer::STANDARD_INPUT);
+	this->source = standard_input ? STDIN_FILENO : ::open(file.c_str(), O_RDONLY);
+
+	if (this->source < 0) {
 		throw BufferInitializationException(std::string("Failed to initialize Buffer, because the file \"") + std::string(file.c_str()) + std::string("\" couldn't be opened!"));
 	}
-}
 
-void Buffer::inject_newline() {
-	this->injected_newline = true;
-	if (this->buffer_size > 0) {
-		*(this->begin) = '\n';
-		++this->end;
+	if (read_ahead_chunks == 0 && this->map_file(this->source)) {
+		if (!standard_input) ::close(this->source);
+		this->source = -1;
+	}
+	else {
+		this->open_window(lookback, buffer_size);
+		if (read_ahead_chunks > 0) this->read_ahead = new ReadAhead(this->source, read_ahead_chunks, buffer_size);
 	}
 }
 
-void Buffer::read_next_chunk() {
-	this->source.read(this->begin, this->buffer_size);
-	this->end = this->begin + this->source.gcount();
-	this->next = this->begin;
+/*
+ * The bytes in [begin, end) must outlive the Buffer, it never reads beyond them.
+ */
+Buffer::Buffer(const char* begin, const char* end)
+	: origin(0), line_index(), mapping(nullptr), mapping_size(0), source(-1), window(nullptr), window_size(0), lookback(0), buffer_size(0), read_ahead(nullptr) {
+	this->limit_size(end - begin);
+	this->begin = this->next = this->marker = const_cast<char*>(begin);
+	this->end = const_cast<char*>(end);
+	this->injected_newline = false;
+	this->line_index.defer(begin, end);
+}
 
-	if (this->begin == this->end) {
-		if (this->injected_newline || (source.tellg() < 0 && !source.eof())) throw BufferBoundsExceededException("Exceeded bounds of file while trying to read chunk!");
-		else this->inject_newline();
-	}
+/*
+ * Tokens store 32 bit offsets, so a source must not exceed 4 GiB.
+ */
+void Buffer::limit_size(std::size_t size) const {
+	if (size > UINT32_MAX) throw BufferInitializationException("Failed to initialize Buffer, because the source exceeds 4 GiB!");
 }
 
-void Buffer::read_previous_chunk() {
-	this->source.clear();
-	this->source.seekg(-((this->back_buffer_end - this->back_buffer_begin) + (this->buffer_size << (this->seek_double_buffer_size ? 1 : 0))), std::ios_base::cur);
-	this->read_next_chunk();
-	this->next = this->end;
+/*
+ * Maps the given file into memory, if it's a non-empty regular file. Returns false, if the file has to be read in chunks instead.
+ */
+bool Buffer::map_file(int descriptor) {
+	struct stat status;
+	if (::fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size <= 0) return false;
+	this->limit_size(static_cast<std::size_t>(status.st_size));
+
+	void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (mapping == MAP_FAILED) return false;
+
+	::madvise(mapping, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+
+	this->mapping = static_cast<char*>(mapping);
+	this->mapping_size = static_cast<std::size_t>(status.st_size);
+	this->begin = this->next = this->marker = this->mapping;
+	this->end = this->mapping + this->mapping_size;
+	this->line_index.defer(this->begin, this->end);
+
+	return true;
 }
 
-void Buffer::read_next_chunk_on_demand() {
-    if (this->next == this->end) {
-	    this->switch_buffer();
-	    if (this->next_chunk_loaded) {
-	        this->next_chunk_loaded = false;
-	        this->next = this->begin;
-	    }
-	    else {
-	        this->read_next_chunk();
-		this->seek_double_buffer_size = true;
-	    }
-            if (this->back_buffer_begin != this->back_buffer_end) this->previous_chunk_loaded = true;
-	}
+void Buffer::open_window(std::size_t lookback, std::size_t buffer_size) {
+	this->window_size = lookback + buffer_size;
+	this->window = static_cast<char*>(::operator new[](this->window_size));
+	this->begin = this->end = this->next = this->marker = this->window;
 }
 
-void Buffer::read_previous_chunk_on_demand() {
-    if (this->next == this->begin) {
-	    this->switch_buffer();
-	    if (this->previous_chunk_loaded) {
-	        this->previous_chunk_loaded = false;
-	        this->next = this->end;
-	    }
-	    else {
-		this->read_previous_chunk();
-		this->seek_double_buffer_size = false;
-	    }
-            if (this->back_buffer_begin != this->back_buffer_end) this->next_chunk_loaded = true;
+/*
+ * Moves the last lookback bytes, or all bytes from the mark on, in front of the window and appends the next chunk of the source.
+ * The window grows, if the marked bytes and a chunk don't fit in. Returns false at the end of the source.
+ */
+bool Buffer::read_next_chunk() {
+	if (this->source < 0) return false;
+
+	std::size_t keep = std::min(std::max(this->lookback, static_cast<std::size_t>(this->next - this->marker)), static_cast<std::size_t>(this->next - this->begin));
+	std::size_t marked = this->next - this->marker;
+	std::size_t discarded = (this->next - keep) - this->begin;
+
+	if (keep + this->buffer_size > this->window_size) {
+		std::size_t window_size = std::max(2 * this->window_size, keep + this->buffer_size);
+		char* window = static_cast<char*>(::operator new[](window_size));
+
+		std::copy(this->next - keep, this->next, window);
+		::operator delete[](this->window);
+
+		this->window = window;
+		this->window_size = window_size;
+	}
+	else std::copy(this->next - keep, this->next, this->window);
+
+	this->origin += discarded;
+	this->begin = this->window;
+	this->next = this->end = this->window + keep;
+	this->marker = this->next - marked;
+
+	ssize_t count;
+	if (this->read_ahead) count = this->read_ahead->read(this->end);
+	else {
+		do {
+			count = ::read(this->source, this->end, this->buffer_size);
+		} while (count < 0 && errno == EINTR);
 	}
+
+	if (count < 0) throw BufferBoundsExceededException("Exceeded bounds of file while trying to read chunk!");
+
+	this->limit_size(this->origin + keep + count);
+	this->line_index.index(this->end, this->end + count);
+	this->end += count;
+	return count > 0;
 }
 
-void Buffer::switch_buffer() {
-    using std::swap;
-    swap(this->begin, this->back_buffer_begin);
-    swap(this->end, this->back_buffer_end);
+/*
+ * The newline terminating the last token is served without being stored in the Buffer, so it doesn't occupy the lookback.
+ */
+int Buffer::inject_newline() {
+	if (this->injected_newline) return Buffer::END_OF_SOURCE;
+
+	this->injected_newline = true;
+	return '\n';
 }
 
-char Buffer::get() {
-    this->read_next_chunk_on_demand();
-    return *(this->next++);
+int Buffer::get() {
+	if (this->next == this->end && !this->read_next_chunk()) return this->inject_newline();
+	return static_cast<unsigned char>(*(this->next++));
 }
 
 char Buffer::unget() {
-    if (this->injected_newline) {
-        this->injected_newline = false;
-        return '\n';
-    }
-    else {
-        this->read_previous_chunk_on_demand();
-        return *(--this->next);
-    }
+	if (this->injected_newline) {
+		this->injected_newline = false;
+		return '\n';
+	}
+
+	if (this->next == this->begin) throw BufferBoundsExceededException("Exceeded bounds of file while trying to unget!");
+	return *(--this->next);
 }
 
 Buffer::~Buffer() {
-	::operator delete[](this->begin < this->back_buffer_begin ? this->begin : this->back_buffer_begin);
+	delete this->read_ahead;
+	if (this->mapping) ::munmap(this->mapping, this->mapping_size);
+	if (this->source > STDERR_FILENO) ::close(this->source);
+	::operator delete[](this->window);
 }
+
+const char* const Buffer::STANDARD_INPUT = "-";
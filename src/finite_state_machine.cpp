@@ -1,206 +1,546 @@
-#include "exception.h"
-#include "finite_state_machine.h"
-#include "character_classification.h"
-#include <limits>
-
-
-/**
-* FiniteStateMachine MUST NOT outlive the State* passed to it => TODO: implement shared_ptr
-**/
-FiniteStateMachine::FiniteStateMachine(const State* start)
-    : states(FiniteStateMachine::gather_states(start))
-    , current_state(FiniteStateMachine::START_STATE_ID)
-    , branch_matrix(states.size(), FiniteStateMachine::SUPPORTED_ENCODING_MAX_VALUE, FiniteStateMachine::CRASH_STATE_ID)
-    , steps_since_last_final_state(0)
-    , last_final_state_index(FiniteStateMachine::CRASH_STATE_ID) {
-
-    if (this->states.size() - 1 > FiniteStateMachine::STATE_TYPE_MAX) throw TooManyMachineStatesException("FiniteStateMachine::FiniteStateMachine(const State*)", FiniteStateMachine::STATE_TYPE_MAX, this->states.size() - 1);
-
-    this->init_branch_matrix();
-}
-
-const Vector<const State*> FiniteStateMachine::gather_states(const State* start) {
-    Vector<const State*> states;
-    states.push_back(&FiniteStateMachine::CRASH_STATE);
-    states.push_back(start);
-
-    for (std::size_t state_index = 0; state_index != states.size(); state_index++) {
-        const Vector<const Transition*>& transitions = states[state_index]->get_transitions();
-        for (Vector<const Transition*>::const_iterator transition_iterator = transitions.cbegin(); transition_iterator != transitions.cend(); transition_iterator++) {
-            const State* next_state = (*transition_iterator)->get_next_state();
-            if (!states.contains(next_state)) states.push_back(next_state);
-        }
-    }
-
-    return states;
-}
-
-void FiniteStateMachine::init_branch_matrix() {
-    Vector<const State*>::const_iterator begin = this->states.cbegin(), end = this->states.cend();
-
-    for (Vector<const State*>::const_iterator iterator = begin; iterator != end; iterator++) {
-        std::size_t current_state_index = std::distance(begin, iterator);
-        const Vector<const Transition*>& transitions = (*iterator)->get_transitions();
-
-        for (Vector<const Transition*>::const_iterator transition_iterator = transitions.cbegin(); transition_iterator != transitions.cend(); transition_iterator++) {
-            const State* next_state = (*transition_iterator)->get_next_state();
-            Vector<const State*>::const_iterator element = this->states.find(next_state);
-
-            if (element == end) throw FatalException("FiniteStateMachine::init_branch_matrix()", "There's a bug! An element which must be in the states Vector was not found");
-
-            std::size_t next_state_index = std::distance(begin, element);
-            this->branch_matrix_entry(*transition_iterator, static_cast<state_type>(current_state_index), static_cast<state_type>(next_state_index));
-        }
-    }
-}
-
-void FiniteStateMachine::branch_matrix_entry(const Transition *transition, state_type current_state_index, state_type next_state_index) {
-    switch(transition->type()) {
-    case TransitionType::CHAR: {
-        const CharTransition *char_transition = static_cast<const CharTransition*>(transition);
-        FiniteStateMachine::state_type symbol = static_cast<FiniteStateMachine::state_type>(char_transition->get_symbol());
-        this->branch_matrix_entry(symbol, current_state_index, next_state_index);
-	break;
-    }
-    case TransitionType::TYPE: {
-        const TypeTransition *type_transition = static_cast<const TypeTransition*>(transition);
-        this->branch_matrix_entry(*type_transition, current_state_index, next_state_index);
-	break;
-    }
-    default: throw UnsupportedTransitionException("FiniteStateMachine::branch_matrix_entry(const Transition*, state_type, state_type)", transition->type());
-    }
-}
-
-void FiniteStateMachine::branch_matrix_entry(state_type symbol, state_type current_state_index, state_type next_state_index) {
-    this->check_encoding(symbol);
-
-    //state_type stored_next_state_index = this->branch_matrix.get(current_state_index, symbol);
-    //if (stored_next_state_index != FiniteStateMachine::CRASH_STATE_ID && stored_next_state_index != next_state_index) throw 1; // TODO: throw proper exception, if the given graph of States and Transitions results in a non-deterministic machine
-
-    this->branch_matrix.set(current_state_index, symbol, next_state_index);
-}
-
-void FiniteStateMachine::branch_matrix_entry(const TypeTransition& transition, state_type current_state_index, state_type next_state_index) {
-    const Vector<char>& values = transition.values();
-    for (Vector<char>::const_iterator iterator = values.cbegin(); iterator != values.cend(); iterator++) {
-        state_type symbol = static_cast<state_type>(*iterator);
-	this->branch_matrix_entry(symbol, current_state_index, next_state_index);
-    }
-}
-
-bool FiniteStateMachine::is_final_state(const State* state) const {
-    switch(this->states[this->current_state]->type()) {
-    case StateType::FINAL:
-    case StateType::CALLBACK_FINAL:
-        return true;
-    case StateType::REGULAR:
-        return false;
-    }
-
-    return false; // TODO:: throw exception if StateType is not supported
-}
-
-void FiniteStateMachine::trigger_callback_state_handler(const State* state, Direction direction, char symbol) const {
-    if (state->type() == StateType::CALLBACK_FINAL) {
-        const CallbackFinalState *callback_state = static_cast<const CallbackFinalState*>(state);
-	(*callback_state)(direction, symbol);
-    }
-}
-
-bool FiniteStateMachine::process(char symbol) {
-    state_type transformed_symbol = static_cast<state_type>(symbol);
-    this->check_encoding(transformed_symbol);
-
-    const State *state = this->states[this->current_state];
-    this->trigger_callback_state_handler(state, Direction::EXIT, symbol);
-
-    this->current_state = this->branch_matrix.get(current_state, transformed_symbol);
-
-    this->trigger_callback_state_handler(this->states[this->current_state], Direction::ENTER, symbol);
-
-    if (this->current_state != FiniteStateMachine::CRASH_STATE_ID && is_final_state(state)) {
-        this->last_final_state_index = this->current_state;
-        this->steps_since_last_final_state = 0;
-    }
-    else this->steps_since_last_final_state++;
-
-    return this->current_state != FiniteStateMachine::CRASH_STATE_ID;
-}
-
-std::size_t FiniteStateMachine::get_steps_since_last_final_state() const {
-    return this->steps_since_last_final_state;
-}
-
-const FinalState& FiniteStateMachine::get_last_final_state() const {
-    return static_cast<const FinalState&>(*(this->states[this->last_final_state_index]));
-}
-
-void FiniteStateMachine::reset() {
-    this->current_state = FiniteStateMachine::START_STATE_ID;
-    this->steps_since_last_final_state = 0;
-    this->last_final_state_index = FiniteStateMachine::CRASH_STATE_ID;
-}
-
-const FinalState FiniteStateMachine::CRASH_STATE = FinalState(TokenType::DEADBEEF);
-const FiniteStateMachine::state_type FiniteStateMachine::CRASH_STATE_ID = 0;
-const FiniteStateMachine::state_type FiniteStateMachine::START_STATE_ID = 1;
-const unsigned char FiniteStateMachine::SUPPORTED_ENCODING_MAX_VALUE = 127;
-const std::size_t FiniteStateMachine::STATE_TYPE_MAX = std::numeric_limits<state_type>::max();
-
-const State* CharTransition::process(char symbol) const {
-	if (this->symbol == symbol) return get_next_state();
-	throw TransitionCharacterProcessingException("Given symbol does not match required symbol.");
-}
-
-const State* TypeTransition::process(char symbol) const {
-	switch(this->get_type()) {
-	case CharClass::ALPHA: {
-		if (is_alpha(symbol)) return this->get_next_state();
-		break;
-	}
-	case CharClass::ALPHA_NUMERIC: {
-		if (is_alnum(symbol)) return this->get_next_state();
-		break;
-	}
-	case CharClass::NUMERIC: {
-		if (is_digit(symbol)) return this->get_next_state();
-		break;
-	}
-	case CharClass::ANY: {
-		return this->get_next_state();
-	}
-	default: throw UncoveredCharClassException(std::string("Switch-statement does not handle given CharClass value: ") + std::to_string(static_cast<int>(this->get_type())));
-	}
-
-	throw TransitionCharacterProcessingException("Given symbol does not match required CharClass.");
-}
-
-const Vector<char>& TypeTransition::values() const {
-    switch(this->get_type()) {
-    case CharClass::NUMERIC: return this->NUMERIC_VALUES;
-    case CharClass::ALPHA: return this->ALPHA_VALUES;
-    case CharClass::ALPHA_NUMERIC: return this->ALPHA_NUMERIC_VALUES;
-    case CharClass::ANY: return this->ANY_VALUES;
-    default: throw UncoveredCharClassException(std::string("Switch-statement does not handle given CharClass value: ") + std::to_string(static_cast<int>(this->get_type())));
-    }
-}
-
-const Vector<char> TypeTransition::NUMERIC_VALUES{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
-const Vector<char> TypeTransition::ALPHA_VALUES{'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'
-					      , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
-const Vector<char> TypeTransition::ALPHA_NUMERIC_VALUES{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'
-						      , 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'
-						      , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
-const Vector<char> TypeTransition::ANY_VALUES{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
-				     , 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
-				     , ' ', '!', '"', '#', '$', '%', '&', '\'', '(', ')', '*', '+', ',', '-', '.', '/'
-				     , '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'
-				     , ':', ';', '<', '=', '>', '?', '@'
-				     , 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T'
-				     , 'U', 'V', 'W', 'X', 'Y', 'Z'
-				     , '[', '\\', ']', '^', '_', '`'
-				     , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't'
-				     , 'u', 'v', 'w', 'x', 'y', 'z'
-				     , '{', '|', '}', '~', 0x7f
-};
-
+#include "exception.h"
+#include "finite_state_machine.h"
+#include "character_classification.h"
+#include <limits>
+
+
+/**
+* FiniteStateMachine MUST NOT outlive the State* passed to it => TODO: implement shared_ptr
+**/
+FiniteStateMachine::FiniteStateMachine(const State* start, bool callbacks_enabled)
+    : states(FiniteStateMachine::gather_states(start))
+    , state_types(FiniteStateMachine::gather_state_types(states))
+    , callbacks_enabled(callbacks_enabled)
+    , symbol_classes(FiniteStateMachine::SYMBOL_COUNT)
+    , branch_matrix(FiniteStateMachine::compress_branch_matrix(this->minimize(this->init_branch_matrix()), &this->symbol_classes))
+    , tokens(this->states.size())
+    , skip_kernels(this->states.size())
+    , tables() {
+
+    this->init_tables();
+}
+
+FiniteStateMachine::FiniteStateMachine(const AutomatonTables& tables)
+    : states(0)
+    , state_types(0)
+    , callbacks_enabled(false)
+    , symbol_classes(0)
+    , branch_matrix(0, 1)
+    , tokens(0)
+    , skip_kernels(0)
+    , tables(tables) {}
+
+/*
+ * Points the tables to the storage built from the State graph.
+ */
+void FiniteStateMachine::init_tables() {
+    for (Vector<const State*>::const_iterator iterator = this->states.cbegin(); iterator != this->states.cend(); iterator++) {
+        bool final_state = (*iterator)->type() != StateType::REGULAR;
+        this->tokens.push_back(final_state ? static_cast<const FinalState*>(*iterator)->token() : TokenType::DEADBEEF);
+    }
+
+    this->tables.state_count = this->states.size();
+    this->tables.symbol_class_count = this->branch_matrix.size_y();
+    this->tables.symbol_classes = this->symbol_classes.cbegin();
+    this->tables.branch_matrix = this->branch_matrix.data();
+    this->tables.state_types = this->state_types.cbegin();
+    this->tables.tokens = this->tokens.cbegin();
+    this->tables.max_steps_since_last_final_state = this->init_max_steps_since_last_final_state();
+
+    for (std::size_t state = 0; state < this->tables.state_count; state++) this->skip_kernels.push_back(this->init_skip_kernel(state));
+    this->tables.skip_kernels = this->skip_kernels.cbegin();
+}
+
+/*
+ * Picks the SkipKernel with the largest set, whose bytes all lead from state back into itself. Callbacks have to see every byte, so
+ * states triggering them never get one.
+ */
+SkipKernel FiniteStateMachine::init_skip_kernel(state_type state) const {
+    if (state == FiniteStateMachine::CRASH_STATE_ID) return SkipKernel::NONE;
+    if (this->callbacks_enabled && this->tables.state_types[state] == StateType::CALLBACK_FINAL) return SkipKernel::NONE;
+
+    const SkipKernel candidates[] = {SkipKernel::COMMENT_BODY, SkipKernel::ALPHA_NUMERIC, SkipKernel::DIGIT, SkipKernel::BLANK};
+    for (SkipKernel kernel : candidates) {
+        bool loops = true;
+        for (std::size_t symbol = 0; symbol < FiniteStateMachine::SYMBOL_COUNT && loops; symbol++) {
+            if (skip_kernel_matches(kernel, static_cast<unsigned char>(symbol))) loops = this->next_state(state, this->tables.symbol_classes[symbol]) == state;
+        }
+        if (loops) return kernel;
+    }
+
+    return SkipKernel::NONE;
+}
+
+const Vector<const State*> FiniteStateMachine::gather_states(const State* start) {
+    Vector<const State*> states;
+    states.push_back(&FiniteStateMachine::CRASH_STATE);
+    states.push_back(start);
+
+    for (std::size_t state_index = 0; state_index != states.size(); state_index++) {
+        const Vector<const Transition*>& transitions = states[state_index]->get_transitions();
+        for (Vector<const Transition*>::const_iterator transition_iterator = transitions.cbegin(); transition_iterator != transitions.cend(); transition_iterator++) {
+            const State* next_state = (*transition_iterator)->get_next_state();
+            if (!states.contains(next_state)) states.push_back(next_state);
+        }
+    }
+
+    return states;
+}
+
+/*
+ * Caches the StateType of every State in a dense array, so process() doesn't need a virtual call per symbol.
+ */
+const Vector<StateType> FiniteStateMachine::gather_state_types(const Vector<const State*>& states) {
+    Vector<StateType> state_types(states.size());
+    for (Vector<const State*>::const_iterator iterator = states.cbegin(); iterator != states.cend(); iterator++) {
+        state_types.push_back((*iterator)->type());
+    }
+
+    return state_types;
+}
+
+/*
+ * Builds the uncompressed branch matrix with one column per symbol. Symbols without a Transition lead to the crash state.
+ */
+BranchMatrix<FiniteStateMachine::state_type> FiniteStateMachine::init_branch_matrix() const {
+    if (this->states.size() - 1 > FiniteStateMachine::STATE_TYPE_MAX) throw TooManyMachineStatesException("FiniteStateMachine::FiniteStateMachine(const State*)", FiniteStateMachine::STATE_TYPE_MAX, this->states.size() - 1);
+
+    BranchMatrix<state_type> branch_matrix(this->states.size(), FiniteStateMachine::SYMBOL_COUNT, FiniteStateMachine::CRASH_STATE_ID);
+    Vector<const State*>::const_iterator begin = this->states.cbegin(), end = this->states.cend();
+
+    for (Vector<const State*>::const_iterator iterator = begin; iterator != end; iterator++) {
+        std::size_t current_state_index = std::distance(begin, iterator);
+        const Vector<const Transition*>& transitions = (*iterator)->get_transitions();
+
+        for (Vector<const Transition*>::const_iterator transition_iterator = transitions.cbegin(); transition_iterator != transitions.cend(); transition_iterator++) {
+            const State* next_state = (*transition_iterator)->get_next_state();
+            Vector<const State*>::const_iterator element = this->states.find(next_state);
+
+            if (element == end) throw FatalException("FiniteStateMachine::init_branch_matrix()", "There's a bug! An element which must be in the states Vector was not found");
+
+            std::size_t next_state_index = std::distance(begin, element);
+            this->branch_matrix_entry(&branch_matrix, *transition_iterator, static_cast<state_type>(current_state_index), static_cast<state_type>(next_state_index));
+        }
+    }
+
+    return branch_matrix;
+}
+
+void FiniteStateMachine::branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const Transition *transition, state_type current_state_index, state_type next_state_index) const {
+    switch(transition->type()) {
+    case TransitionType::CHAR: {
+        const CharTransition *char_transition = static_cast<const CharTransition*>(transition);
+        FiniteStateMachine::state_type symbol = static_cast<FiniteStateMachine::state_type>(char_transition->get_symbol());
+        this->branch_matrix_entry(branch_matrix, symbol, current_state_index, next_state_index);
+	break;
+    }
+    case TransitionType::TYPE: {
+        const TypeTransition *type_transition = static_cast<const TypeTransition*>(transition);
+        this->branch_matrix_entry(branch_matrix, *type_transition, current_state_index, next_state_index);
+	break;
+    }
+    case TransitionType::RANGE: {
+        const RangeTransition *range_transition = static_cast<const RangeTransition*>(transition);
+        this->branch_matrix_entry(branch_matrix, *range_transition, current_state_index, next_state_index);
+	break;
+    }
+    default: throw UnsupportedTransitionException("FiniteStateMachine::branch_matrix_entry(BranchMatrix<state_type>*, const Transition*, state_type, state_type)", transition->type());
+    }
+}
+
+void FiniteStateMachine::branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, state_type symbol, state_type current_state_index, state_type next_state_index) const {
+    //state_type stored_next_state_index = branch_matrix->get(current_state_index, symbol);
+    //if (stored_next_state_index != FiniteStateMachine::CRASH_STATE_ID && stored_next_state_index != next_state_index) throw 1; // TODO: throw proper exception, if the given graph of States and Transitions results in a non-deterministic machine
+
+    branch_matrix->set(current_state_index, symbol, next_state_index);
+}
+
+void FiniteStateMachine::branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const TypeTransition& transition, state_type current_state_index, state_type next_state_index) const {
+    const Vector<char>& values = transition.values();
+    for (Vector<char>::const_iterator iterator = values.cbegin(); iterator != values.cend(); iterator++) {
+        state_type symbol = static_cast<state_type>(*iterator);
+	this->branch_matrix_entry(branch_matrix, symbol, current_state_index, next_state_index);
+    }
+}
+
+void FiniteStateMachine::branch_matrix_entry(BranchMatrix<state_type>* branch_matrix, const RangeTransition& transition, state_type current_state_index, state_type next_state_index) const {
+    for (std::size_t symbol = transition.get_first(); symbol <= transition.get_last(); symbol++) {
+	this->branch_matrix_entry(branch_matrix, static_cast<state_type>(symbol), current_state_index, next_state_index);
+    }
+}
+
+/*
+ * Merges equivalent states with Hopcroft's partition refinement and returns the branch matrix of the minimal machine. states and
+ * state_types are reduced to one representative per block of equivalent states. The crash and start state keep their IDs.
+ * States are only merged, if they share their StateType and TokenType. CallbackFinalStates are never merged with other states, unless
+ * callbacks are disabled, as their callbacks can't be compared.
+ */
+BranchMatrix<FiniteStateMachine::state_type> FiniteStateMachine::minimize(const BranchMatrix<state_type>& branch_matrix) {
+    std::size_t state_count = this->states.size();
+    Vector<std::size_t> block_of_state(state_count, 0);
+    Vector<Vector<std::size_t>> blocks;
+
+    for (std::size_t state = 0; state < state_count; state++) {
+        std::size_t block = 0;
+        while (block < blocks.size() && !this->equivalent_state_kind(blocks[block][0], state)) block++;
+
+        if (block == blocks.size()) blocks.push_back(Vector<std::size_t>());
+        blocks[block].push_back(state);
+        block_of_state[state] = block;
+    }
+
+    Vector<Vector<std::size_t>> predecessors(state_count * FiniteStateMachine::SYMBOL_COUNT, Vector<std::size_t>(0));
+    for (std::size_t state = 0; state < state_count; state++) {
+        for (std::size_t symbol = 0; symbol < FiniteStateMachine::SYMBOL_COUNT; symbol++) {
+            predecessors[branch_matrix.get(state, symbol) * FiniteStateMachine::SYMBOL_COUNT + symbol].push_back(state);
+        }
+    }
+
+    Vector<std::size_t> worklist;
+    Vector<bool> in_worklist(state_count, false);
+    for (std::size_t block = 0; block < blocks.size(); block++) {
+        worklist.push_back(block);
+        in_worklist[block] = true;
+    }
+
+    Vector<bool> marked(state_count, false);
+    while (worklist.size() > 0) {
+        std::size_t splitter = worklist.pop_back();
+        in_worklist[splitter] = false;
+        Vector<std::size_t> splitter_states(blocks[splitter]);
+
+        for (std::size_t symbol = 0; symbol < FiniteStateMachine::SYMBOL_COUNT; symbol++) {
+            Vector<std::size_t> touched_blocks;
+
+            for (Vector<std::size_t>::const_iterator target = splitter_states.cbegin(); target != splitter_states.cend(); target++) {
+                const Vector<std::size_t>& sources = predecessors[*target * FiniteStateMachine::SYMBOL_COUNT + symbol];
+                for (Vector<std::size_t>::const_iterator source = sources.cbegin(); source != sources.cend(); source++) {
+                    if (marked[*source]) continue;
+
+                    marked[*source] = true;
+                    if (!touched_blocks.contains(block_of_state[*source])) touched_blocks.push_back(block_of_state[*source]);
+                }
+            }
+
+            for (Vector<std::size_t>::const_iterator block = touched_blocks.cbegin(); block != touched_blocks.cend(); block++) {
+                Vector<std::size_t> inside, outside;
+                for (Vector<std::size_t>::const_iterator state = blocks[*block].cbegin(); state != blocks[*block].cend(); state++) {
+                    if (marked[*state]) inside.push_back(*state);
+                    else outside.push_back(*state);
+                }
+
+                if (outside.size() > 0) {
+                    std::size_t new_block = blocks.size();
+                    blocks[*block] = inside;
+                    blocks.push_back(outside);
+                    for (Vector<std::size_t>::const_iterator state = outside.cbegin(); state != outside.cend(); state++) block_of_state[*state] = new_block;
+
+                    if (in_worklist[*block] || outside.size() <= inside.size()) {
+                        worklist.push_back(new_block);
+                        in_worklist[new_block] = true;
+                    }
+                    else if (!in_worklist[*block]) {
+                        worklist.push_back(*block);
+                        in_worklist[*block] = true;
+                    }
+                }
+
+                for (Vector<std::size_t>::const_iterator state = inside.cbegin(); state != inside.cend(); state++) marked[*state] = false;
+            }
+
+            for (std::size_t state = 0; state < state_count; state++) marked[state] = false;
+        }
+    }
+
+    Vector<state_type> block_ids(blocks.size(), FiniteStateMachine::CRASH_STATE_ID);
+    Vector<const State*> states;
+    Vector<StateType> state_types;
+    for (std::size_t state = 0; state < state_count; state++) {
+        std::size_t block = block_of_state[state];
+        if (state > FiniteStateMachine::CRASH_STATE_ID && block == block_of_state[FiniteStateMachine::CRASH_STATE_ID]) continue;
+        if (state > FiniteStateMachine::START_STATE_ID && block == block_of_state[FiniteStateMachine::START_STATE_ID]) continue;
+        if (state > FiniteStateMachine::START_STATE_ID && block_ids[block] != FiniteStateMachine::CRASH_STATE_ID) continue;
+
+        block_ids[block] = static_cast<state_type>(states.size());
+        states.push_back(this->states[state]);
+        state_types.push_back(this->state_types[state]);
+    }
+
+    BranchMatrix<state_type> minimal_branch_matrix(states.size(), FiniteStateMachine::SYMBOL_COUNT, FiniteStateMachine::CRASH_STATE_ID);
+    for (std::size_t state = 0; state < state_count; state++) {
+        state_type minimal_state = block_ids[block_of_state[state]];
+        for (std::size_t symbol = 0; symbol < FiniteStateMachine::SYMBOL_COUNT; symbol++) {
+            minimal_branch_matrix.set(minimal_state, symbol, block_ids[block_of_state[branch_matrix.get(state, symbol)]]);
+        }
+    }
+
+    this->states = states;
+    this->state_types = state_types;
+
+    return minimal_branch_matrix;
+}
+
+bool FiniteStateMachine::equivalent_state_kind(state_type left, state_type right) const {
+    if ((left == FiniteStateMachine::CRASH_STATE_ID) != (right == FiniteStateMachine::CRASH_STATE_ID)) return false;
+    bool left_final = this->state_types[left] != StateType::REGULAR, right_final = this->state_types[right] != StateType::REGULAR;
+    if (left_final != right_final) return false;
+    if (!left_final) return true;
+
+    if (this->callbacks_enabled && (this->state_types[left] == StateType::CALLBACK_FINAL || this->state_types[right] == StateType::CALLBACK_FINAL)) return left == right;
+
+    return static_cast<const FinalState*>(this->states[left])->token() == static_cast<const FinalState*>(this->states[right])->token();
+}
+
+/*
+ * Groups symbols, whose columns are identical for every state, into one symbol class and returns the branch matrix with one column per
+ * class. symbol_classes receives the class of every symbol, so process() needs one additional lookup, but the matrix shrinks from
+ * states x 256 to states x classes.
+ */
+BranchMatrix<FiniteStateMachine::state_type> FiniteStateMachine::compress_branch_matrix(const BranchMatrix<state_type>& branch_matrix, Vector<state_type>* symbol_classes) {
+    Vector<std::size_t> class_representatives;
+
+    for (std::size_t symbol = 0; symbol < FiniteStateMachine::SYMBOL_COUNT; symbol++) {
+        std::size_t symbol_class = 0;
+        while (symbol_class < class_representatives.size() && !FiniteStateMachine::equal_columns(branch_matrix, class_representatives[symbol_class], symbol)) symbol_class++;
+
+        if (symbol_class == class_representatives.size()) class_representatives.push_back(symbol);
+        symbol_classes->push_back(static_cast<state_type>(symbol_class));
+    }
+
+    BranchMatrix<state_type> compressed_branch_matrix(branch_matrix.size_x(), class_representatives.size(), FiniteStateMachine::CRASH_STATE_ID);
+    for (std::size_t state = 0; state < branch_matrix.size_x(); state++) {
+        for (std::size_t symbol_class = 0; symbol_class < class_representatives.size(); symbol_class++) {
+            compressed_branch_matrix.set(state, symbol_class, branch_matrix.get(state, class_representatives[symbol_class]));
+        }
+    }
+
+    return compressed_branch_matrix;
+}
+
+bool FiniteStateMachine::equal_columns(const BranchMatrix<state_type>& branch_matrix, std::size_t left, std::size_t right) {
+    for (std::size_t state = 0; state < branch_matrix.size_x(); state++) {
+        if (branch_matrix.get(state, left) != branch_matrix.get(state, right)) return false;
+    }
+
+    return true;
+}
+
+FiniteStateMachine::state_type FiniteStateMachine::next_state(state_type state, std::size_t symbol_class) const {
+    return this->tables.branch_matrix[state * this->tables.symbol_class_count + symbol_class];
+}
+
+bool FiniteStateMachine::is_final_state(state_type state) const {
+    return this->tables.state_types[state] != StateType::REGULAR;
+}
+
+void FiniteStateMachine::trigger_callback_state_handler(state_type state, Direction direction, char symbol) const {
+    if (this->callbacks_enabled && this->tables.state_types[state] == StateType::CALLBACK_FINAL) {
+        const CallbackFinalState *callback_state = static_cast<const CallbackFinalState*>(this->states[state]);
+	(*callback_state)(direction, symbol);
+    }
+}
+
+/*
+ * Returns the maximum value get_steps_since_last_final_state() can reach, which is the amount of symbols a caller may have to backtrack.
+ */
+std::size_t FiniteStateMachine::get_max_steps_since_last_final_state() const {
+    return this->tables.max_steps_since_last_final_state;
+}
+
+/*
+ * That's the longest chain of non-final states, which can be entered after the start state or a final state, plus the symbol leading
+ * into the crash state.
+ */
+std::size_t FiniteStateMachine::init_max_steps_since_last_final_state() const {
+    Vector<std::size_t> lengths(this->tables.state_count, 0);
+    Vector<bool> visiting(this->tables.state_count, false);
+    std::size_t max_length = 0;
+
+    for (std::size_t state_index = 0; state_index < this->tables.state_count; state_index++) {
+        if (state_index != FiniteStateMachine::START_STATE_ID && (state_index == FiniteStateMachine::CRASH_STATE_ID || !this->is_final_state(state_index))) continue;
+
+        for (std::size_t symbol_class = 0; symbol_class < this->tables.symbol_class_count; symbol_class++) {
+            state_type next_state_index = this->next_state(state_index, symbol_class);
+            max_length = std::max(max_length, this->regular_chain_length(next_state_index, &lengths, &visiting));
+        }
+    }
+
+    return max_length + 1;
+}
+
+std::size_t FiniteStateMachine::regular_chain_length(state_type state, Vector<std::size_t>* lengths, Vector<bool>* visiting) const {
+    if (state == FiniteStateMachine::CRASH_STATE_ID || this->is_final_state(state)) return 0;
+    if ((*visiting)[state]) throw UnboundedBacktrackException("FiniteStateMachine::init_max_steps_since_last_final_state()");
+    if ((*lengths)[state] != 0) return (*lengths)[state];
+
+    (*visiting)[state] = true;
+
+    std::size_t max_length = 0;
+    for (std::size_t symbol_class = 0; symbol_class < this->tables.symbol_class_count; symbol_class++) {
+        max_length = std::max(max_length, this->regular_chain_length(this->next_state(state, symbol_class), lengths, visiting));
+    }
+
+    (*visiting)[state] = false;
+    return (*lengths)[state] = max_length + 1;
+}
+
+const AutomatonTables& FiniteStateMachine::get_tables() const {
+    return this->tables;
+}
+
+FiniteStateMachineCursor::FiniteStateMachineCursor(const FiniteStateMachine& finite_state_machine)
+    : finite_state_machine(&finite_state_machine)
+    , current_state(FiniteStateMachine::START_STATE_ID)
+    , steps_since_last_final_state(0)
+    , last_final_state_index(FiniteStateMachine::CRASH_STATE_ID) {}
+
+bool FiniteStateMachineCursor::process(char symbol) {
+    const FiniteStateMachine& finite_state_machine = *(this->finite_state_machine);
+    state_type transformed_symbol = static_cast<state_type>(symbol);
+
+    finite_state_machine.trigger_callback_state_handler(this->current_state, Direction::EXIT, symbol);
+
+    this->current_state = finite_state_machine.next_state(this->current_state, finite_state_machine.tables.symbol_classes[transformed_symbol]);
+
+    finite_state_machine.trigger_callback_state_handler(this->current_state, Direction::ENTER, symbol);
+
+    if (this->current_state != FiniteStateMachine::CRASH_STATE_ID && finite_state_machine.is_final_state(this->current_state)) {
+        this->last_final_state_index = this->current_state;
+        this->steps_since_last_final_state = 0;
+    }
+    else this->steps_since_last_final_state++;
+
+    return this->current_state != FiniteStateMachine::CRASH_STATE_ID;
+}
+
+const char* FiniteStateMachineCursor::process(const char* begin, const char* end) {
+    const FiniteStateMachine& finite_state_machine = *(this->finite_state_machine);
+
+    if (finite_state_machine.callbacks_enabled) {
+        while (begin != end && finite_state_machine.next_state(this->current_state, finite_state_machine.tables.symbol_classes[static_cast<state_type>(*begin)]) != FiniteStateMachine::CRASH_STATE_ID) {
+            this->process(*begin++);
+            if (this->get_skip_kernel() != SkipKernel::NONE) break;
+        }
+        return begin;
+    }
+
+    const AutomatonTables& tables = finite_state_machine.tables;
+    state_type current_state = this->current_state;
+    std::size_t steps_since_last_final_state = this->steps_since_last_final_state;
+    state_type last_final_state_index = this->last_final_state_index;
+
+    while (begin != end) {
+        state_type next_state = tables.branch_matrix[current_state * tables.symbol_class_count + tables.symbol_classes[static_cast<state_type>(*begin)]];
+        if (next_state == FiniteStateMachine::CRASH_STATE_ID) break;
+
+        ++begin;
+        current_state = next_state;
+
+        if (tables.state_types[current_state] != StateType::REGULAR) {
+            last_final_state_index = current_state;
+            steps_since_last_final_state = 0;
+        }
+        else steps_since_last_final_state++;
+
+        if (tables.skip_kernels[current_state] != SkipKernel::NONE) break;
+    }
+
+    this->current_state = current_state;
+    this->steps_since_last_final_state = steps_since_last_final_state;
+    this->last_final_state_index = last_final_state_index;
+    return begin;
+}
+
+bool FiniteStateMachineCursor::accepts(char symbol) const {
+    const FiniteStateMachine& finite_state_machine = *(this->finite_state_machine);
+    return finite_state_machine.next_state(this->current_state, finite_state_machine.tables.symbol_classes[static_cast<state_type>(symbol)]) != FiniteStateMachine::CRASH_STATE_ID;
+}
+
+std::size_t FiniteStateMachineCursor::get_steps_since_last_final_state() const {
+    return this->steps_since_last_final_state;
+}
+
+TokenType FiniteStateMachineCursor::get_last_final_token() const {
+    return this->finite_state_machine->tables.tokens[this->last_final_state_index];
+}
+
+void FiniteStateMachineCursor::reset() {
+    this->current_state = FiniteStateMachine::START_STATE_ID;
+    this->steps_since_last_final_state = 0;
+    this->last_final_state_index = FiniteStateMachine::CRASH_STATE_ID;
+}
+
+void FiniteStateMachineCursor::resume_last_final_state() {
+    this->current_state = this->last_final_state_index;
+    this->steps_since_last_final_state = 0;
+}
+
+const FinalState FiniteStateMachine::CRASH_STATE = FinalState(TokenType::DEADBEEF);
+const FiniteStateMachine::state_type FiniteStateMachine::CRASH_STATE_ID = 0;
+const FiniteStateMachine::state_type FiniteStateMachine::START_STATE_ID = 1;
+const std::size_t FiniteStateMachine::STATE_TYPE_MAX = std::numeric_limits<state_type>::max();
+const std::size_t FiniteStateMachine::SYMBOL_COUNT = std::numeric_limits<state_type>::max() + 1;
+
+const State* CharTransition::process(char symbol) const {
+	if (this->symbol == symbol) return get_next_state();
+	throw TransitionCharacterProcessingException("Given symbol does not match required symbol.");
+}
+
+const State* RangeTransition::process(char symbol) const {
+	unsigned char value = static_cast<unsigned char>(symbol);
+	if (value >= this->first && value <= this->last) return this->get_next_state();
+	throw TransitionCharacterProcessingException("Given symbol is not within the required range.");
+}
+
+const State* TypeTransition::process(char symbol) const {
+	switch(this->get_type()) {
+	case CharClass::ALPHA: {
+		if (is_alpha(symbol)) return this->get_next_state();
+		break;
+	}
+	case CharClass::ALPHA_NUMERIC: {
+		if (is_alnum(symbol)) return this->get_next_state();
+		break;
+	}
+	case CharClass::NUMERIC: {
+		if (is_digit(symbol)) return this->get_next_state();
+		break;
+	}
+	case CharClass::ANY: {
+		return this->get_next_state();
+	}
+	default: throw UncoveredCharClassException(std::string("Switch-statement does not handle given CharClass value: ") + std::to_string(static_cast<int>(this->get_type())));
+	}
+
+	throw TransitionCharacterProcessingException("Given symbol does not match required CharClass.");
+}
+
+const Vector<char>& TypeTransition::values() const {
+    switch(this->get_type()) {
+    case CharClass::NUMERIC: return this->NUMERIC_VALUES;
+    case CharClass::ALPHA: return this->ALPHA_VALUES;
+    case CharClass::ALPHA_NUMERIC: return this->ALPHA_NUMERIC_VALUES;
+    case CharClass::ANY: return this->ANY_VALUES;
+    default: throw UncoveredCharClassException(std::string("Switch-statement does not handle given CharClass value: ") + std::to_string(static_cast<int>(this->get_type())));
+    }
+}
+
+const Vector<char> TypeTransition::NUMERIC_VALUES{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+const Vector<char> TypeTransition::ALPHA_VALUES{'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'
+					      , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
+const Vector<char> TypeTransition::ALPHA_NUMERIC_VALUES{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'
+						      , 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'
+						      , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
+const Vector<char> TypeTransition::ANY_VALUES{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+				     , 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+				     , ' ', '!', '"', '#', '$', '%', '&', '\'', '(', ')', '*', '+', ',', '-', '.', '/'
+				     , '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'
+				     , ':', ';', '<', '=', '>', '?', '@'
+				     , 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T'
+				     , 'U', 'V', 'W', 'X', 'Y', 'Z'
+				     , '[', '\\', ']', '^', '_', '`'
+				     , 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't'
+				     , 'u', 'v', 'w', 'x', 'y', 'z'
+				     , '{', '|', '}', '~', 0x7f
+};
+
@@ -0,0 +1,73 @@
+#include <iostream>
+#include "finite_state_machine.h"
+#include "scanner_graph.h"
+#include "token.h"
+
+/*
+ * Builds the scanner's FiniteStateMachine from its State graph and prints the minimized, compressed tables as constexpr arrays.
+ * The makefile runs this once per build and the Scanner includes the output, so it pays no construction work at runtime.
+ */
+
+void print_bytes(std::ostream& out, const char* name, const unsigned char* values, std::size_t count, std::size_t row_length) {
+	out << "constexpr unsigned char " << name << "[" << count << "] = {";
+	for (std::size_t index = 0; index < count; index++) {
+		out << (index % row_length == 0 ? "\n\t" : " ") << static_cast<unsigned int>(values[index]) << ",";
+	}
+	out << "\n};\n\n";
+}
+
+const char* state_type_name(StateType state_type) {
+	switch(state_type) {
+	case StateType::REGULAR: return "StateType::REGULAR";
+	case StateType::FINAL: return "StateType::FINAL";
+	case StateType::CALLBACK_FINAL: return "StateType::CALLBACK_FINAL";
+	}
+	return "StateType::REGULAR";
+}
+
+const char* skip_kernel_name(SkipKernel kernel) {
+	switch(kernel) {
+	case SkipKernel::NONE: return "SkipKernel::NONE";
+	case SkipKernel::BLANK: return "SkipKernel::BLANK";
+	case SkipKernel::DIGIT: return "SkipKernel::DIGIT";
+	case SkipKernel::ALPHA_NUMERIC: return "SkipKernel::ALPHA_NUMERIC";
+	case SkipKernel::COMMENT_BODY: return "SkipKernel::COMMENT_BODY";
+	case SkipKernel::LINE_BODY: return "SkipKernel::LINE_BODY";
+	}
+	return "SkipKernel::NONE";
+}
+
+int main() {
+	try {
+		FiniteStateMachine finite_state_machine(scanner_graph(), false);
+		const AutomatonTables& tables = finite_state_machine.get_tables();
+
+		std::cout << "/* Generated by generate_scanner_tables from scanner_graph.cpp. Do not edit. */\n\n";
+		std::cout << "#ifndef SCANNER_TABLES_H\n#define SCANNER_TABLES_H\n\n#include \"finite_state_machine.h\"\n\n";
+
+		print_bytes(std::cout, "SCANNER_SYMBOL_CLASSES", tables.symbol_classes, 256, 16);
+		print_bytes(std::cout, "SCANNER_BRANCH_MATRIX", tables.branch_matrix, tables.state_count * tables.symbol_class_count, tables.symbol_class_count);
+
+		std::cout << "constexpr StateType SCANNER_STATE_TYPES[" << tables.state_count << "] = {";
+		for (std::size_t state = 0; state < tables.state_count; state++) std::cout << "\n\t" << state_type_name(tables.state_types[state]) << ",";
+		std::cout << "\n};\n\n";
+
+		std::cout << "constexpr TokenType SCANNER_TOKENS[" << tables.state_count << "] = {";
+		for (std::size_t state = 0; state < tables.state_count; state++) std::cout << "\n\tTokenType::" << tables.tokens[state] << ",";
+		std::cout << "\n};\n\n";
+
+		std::cout << "constexpr SkipKernel SCANNER_SKIP_KERNELS[" << tables.state_count << "] = {";
+		for (std::size_t state = 0; state < tables.state_count; state++) std::cout << "\n\t" << skip_kernel_name(tables.skip_kernels[state]) << ",";
+		std::cout << "\n};\n\n";
+
+		std::cout << "constexpr AutomatonTables SCANNER_TABLES = {\n\t" << tables.state_count << ",\n\t" << tables.symbol_class_count << ",\n\t"
+		          << tables.max_steps_since_last_final_state << ",\n\tSCANNER_SYMBOL_CLASSES,\n\tSCANNER_BRANCH_MATRIX,\n\tSCANNER_STATE_TYPES,\n\tSCANNER_TOKENS,\n\tSCANNER_SKIP_KERNELS\n};\n\n";
+
+		std::cout << "#endif /* SCANNER_TABLES_H */\n";
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
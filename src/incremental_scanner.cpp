@@ -0,0 +1,110 @@
+#include "incremental_scanner.h"
+#include "exception.h"
+#include <algorithm>
+
+IncrementalScanner::IncrementalScanner(const char* begin, const char* end) : source(begin, end - begin), tokens(), symboltable(), line_index() {
+	this->edit(0, 0, nullptr, 0);
+}
+
+/*
+ * Returns the index of the last token other than an error token in front of line_begin, or the count of tokens, if there's none. The
+ * Scanner was in its start state in front of it, and never looked beyond the line feed in front of line_begin to get there.
+ */
+std::size_t IncrementalScanner::restart_token(std::uint32_t line_begin) const {
+	const Token* begin = this->tokens.cbegin();
+	const Token* token = std::lower_bound(begin, this->tokens.cend(), line_begin, [](const Token& token, std::uint32_t offset) { return token.offset < offset; });
+
+	while (token != begin) {
+		--token;
+		if ((*token).get_token_type() != TokenType::UNSUPPORTED_CHARACTER) return token - begin;
+	}
+
+	return this->tokens.size();
+}
+
+/*
+ * Behind the edit, the old and the new source agree again, only their offsets differ. A token of the new scan, which starts at the same
+ * place as a token of the old scan, starts in the start state of both scans. So all tokens from it on are the same, except for their
+ * offsets.
+ */
+IncrementalScanner::TokenSpan IncrementalScanner::edit(std::size_t offset, std::size_t removed_size, const char* inserted, std::size_t inserted_size) {
+	if (offset > this->source.size() || removed_size > this->source.size() - offset) {
+		throw BufferBoundsExceededException("Edit exceeds the bounds of the source!");
+	}
+
+	this->source.replace(offset, removed_size, inserted, inserted + inserted_size);
+
+	const char* begin = this->source.cbegin();
+	const char* end = this->source.cend();
+
+	this->line_index.splice(begin, end, static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(removed_size), static_cast<std::uint32_t>(inserted_size));
+
+	std::reverse_iterator<const char*> line_feed = std::find_if(std::reverse_iterator<const char*>(begin + offset), std::reverse_iterator<const char*>(begin),
+		[](char symbol) { return symbol == '\n' || symbol == '\r'; });
+	std::size_t restart = this->restart_token(static_cast<std::uint32_t>(line_feed.base() - begin));
+	std::size_t first = 0;
+	std::uint32_t restart_offset = 0;
+
+	if (restart != this->tokens.size()) {
+		restart_offset = this->tokens[restart].offset;
+		for (first = restart; first > 0 && this->tokens[first - 1].offset > restart_offset; first--);
+	}
+
+	std::uint32_t inserted_end = static_cast<std::uint32_t>(offset + inserted_size), removed_end = static_cast<std::uint32_t>(offset + removed_size);
+	Scanner scanner(begin + restart_offset, end);
+	Vector<Token> scanned;
+	std::size_t replaced_end = this->tokens.size(), old_index = first;
+
+	while (true) {
+		Token token = scanner.next_token();
+		TokenType token_type = token.get_token_type();
+
+		token.offset += restart_offset;
+
+		if (token_type == TokenType::IDENTIFIER || token_type == TokenType::OUT_OF_RANGE_INTEGER) {
+			token.value.symbol = this->symboltable.insert(Lexeme(token.get_lexem(scanner.get_symboltable())), token_type);
+		}
+		else if (token_type == TokenType::INTEGER) {
+			token.value.literal = this->symboltable.insert_literal(token.get_integer(scanner.get_symboltable()));
+		}
+
+		if (token_type != TokenType::UNSUPPORTED_CHARACTER && token.offset >= inserted_end) {
+			std::uint32_t old_offset = token.offset - inserted_end + removed_end;
+
+			while (old_index < this->tokens.size() && (this->tokens[old_index].offset < old_offset
+				|| this->tokens[old_index].get_token_type() == TokenType::UNSUPPORTED_CHARACTER)) old_index++;
+
+			if (old_index < this->tokens.size() && this->tokens[old_index].offset == old_offset && this->tokens[old_index].get_token_type() == token_type) {
+				replaced_end = old_index;
+				break;
+			}
+		}
+
+		scanned.push_back(token);
+		if (token_type == TokenType::END_OF_FILE) break;
+	}
+
+	/*
+	 * Splices the scanned tokens in place, so only the tokens behind them are moved.
+	 */
+	std::size_t replaced_size = replaced_end - first, moved_size = this->tokens.size() - replaced_end;
+
+	if (scanned.size() > replaced_size) {
+		for (std::size_t count = scanned.size() - replaced_size; count > 0; count--) this->tokens.push_back(Token());
+		std::move_backward(this->tokens.begin() + replaced_end, this->tokens.begin() + replaced_end + moved_size, this->tokens.end());
+	}
+	else if (scanned.size() < replaced_size) {
+		Vector<Token>::iterator moved_end = std::move(this->tokens.begin() + replaced_end, this->tokens.end(), this->tokens.begin() + first + scanned.size());
+		while (this->tokens.end() != moved_end) this->tokens.erase(this->tokens.end() - 1);
+	}
+
+	std::copy(scanned.begin(), scanned.end(), this->tokens.begin() + first);
+
+	if (inserted_size != removed_size) {
+		for (Vector<Token>::iterator token = this->tokens.begin() + first + scanned.size(), end = this->tokens.end(); token != end; ++token) {
+			(*token).offset = (*token).offset - removed_end + inserted_end;
+		}
+	}
+
+	return TokenSpan(first, first + scanned.size(), replaced_end);
+}
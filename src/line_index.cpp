@@ -0,0 +1,95 @@
+#include "line_index.h"
+#include "skip_kernels.h"
+#include <algorithm>
+
+std::ostream& operator<<(std::ostream& out, const LocatedToken& located_token) {
+	out << located_token.line_index.resolve(located_token.token.token.offset);
+	out.write(": ", 2);
+	return out << located_token.token;
+}
+
+/*
+ * A "\n" right behind a "\r" only moves the beginning of the line the "\r" started, even if the "\r" ended the previous chunk.
+ */
+void LineIndex::index(const char* begin, const char* end) {
+	if (begin == end) return;
+
+	for (const char* line_feed = ::skip_run(SkipKernel::LINE_BODY, begin, end); line_feed != end; line_feed = ::skip_run(SkipKernel::LINE_BODY, line_feed + 1, end)) {
+		std::uint32_t line_begin = static_cast<std::uint32_t>(this->indexed_size + (line_feed - begin) + 1);
+		bool carriage_return = line_feed == begin ? this->carriage_return : *(line_feed - 1) == '\r';
+
+		if (*line_feed == '\n' && carriage_return) *(this->line_begins.end() - 1) = line_begin;
+		else this->line_begins.push_back(line_begin);
+	}
+
+	this->indexed_size += end - begin;
+	this->carriage_return = *(end - 1) == '\r';
+}
+
+void LineIndex::defer(const char* begin, const char* end) {
+	this->deferred_begin = begin;
+	this->deferred_end = end;
+}
+
+/*
+ * Forgets the line feeds indexed from offset on, the bytes from there on are indexed on demand again. A line begin up to offset belongs
+ * to a line feed in front of it, which is still there. A "\r" right in front of offset may have been
+ * merged with a "\n" behind it, its own line begin is restored then. A "\n" at offset continues it just like at the end of a chunk.
+ */
+void LineIndex::invalidate(const char* begin, const char* end, std::uint32_t offset) {
+	std::uint32_t kept_size = static_cast<std::uint32_t>(std::min<std::size_t>(offset, this->indexed_size));
+
+	while (this->line_begins.size() != 0 && *(this->line_begins.end() - 1) > kept_size) this->line_begins.pop_back();
+
+	this->indexed_size = kept_size;
+	this->carriage_return = kept_size != 0 && begin[kept_size - 1] == '\r';
+	if (this->carriage_return && (this->line_begins.size() == 0 || *(this->line_begins.end() - 1) != kept_size)) this->line_begins.push_back(kept_size);
+
+	this->defer(begin + kept_size, end);
+}
+
+/*
+ * Indexes the inserted bytes and the byte behind them, which may continue a "\r" in front of it, and moves the line begins behind that
+ * byte. If it continues a "\r" now, it did so before, and its line begin replaces the one of the "\r". Without an indexed byte behind
+ * the edit, the bytes from offset on are indexed on demand again.
+ */
+void LineIndex::splice(const char* begin, const char* end, std::uint32_t offset, std::uint32_t removed_size, std::uint32_t inserted_size) {
+	std::uint32_t removed_end = offset + removed_size, inserted_end = offset + inserted_size;
+
+	if (this->indexed_size <= removed_end) {
+		this->invalidate(begin, end, offset);
+		return;
+	}
+
+	Vector<std::uint32_t> moved(std::lower_bound(this->line_begins.cbegin(), this->line_begins.cend(), removed_end + 2), this->line_begins.cend());
+	std::size_t indexed_size = this->indexed_size - removed_size + inserted_size;
+	bool deferred = this->deferred_begin != nullptr;
+
+	this->invalidate(begin, end, offset);
+	this->index(begin + offset, begin + inserted_end + 1);
+	this->line_begins.reserve(this->line_begins.size() + moved.size());
+
+	Vector<std::uint32_t>::const_iterator line_begin = moved.cbegin();
+	if (line_begin != moved.cend() && begin[inserted_end] == '\r' && begin[inserted_end + 1] == '\n') {
+		*(this->line_begins.end() - 1) = *(line_begin++) - removed_size + inserted_size;
+	}
+	for (; line_begin != moved.cend(); ++line_begin) this->line_begins.push_back(*line_begin - removed_size + inserted_size);
+
+	this->indexed_size = indexed_size;
+	this->carriage_return = begin[indexed_size - 1] == '\r';
+
+	if (deferred) this->defer(begin + indexed_size, end);
+	else this->deferred_begin = this->deferred_end = nullptr;
+}
+
+FilePosition LineIndex::resolve(std::uint32_t offset) {
+	if (this->deferred_begin) {
+		this->index(this->deferred_begin, this->deferred_end);
+		this->deferred_begin = this->deferred_end = nullptr;
+	}
+
+	std::size_t line = std::upper_bound(this->line_begins.cbegin(), this->line_begins.cend(), offset) - this->line_begins.cbegin();
+	std::uint32_t line_begin = line == 0 ? 0 : this->line_begins[line - 1];
+
+	return FilePosition(line + 1, offset - line_begin + 1);
+}
@@ -1,10 +1,14 @@
 #include "scanner.h"
+#include "parallel_scanner.h"
 #include "grammar.h"
 #include "parser.h"
 #include "parse_tree.h"
 #include "type_check.h"
 #include "make_code.h"
 #include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
 
 enum Exit {
 	EXIT_SUCCESS_0,
@@ -16,39 +20,122 @@ enum Exit {
 };
 
 
-void parse(Scanner* scanner, Parser* parser, bool* is_scan_valid) {
+/* Every chunk holds Buffer::BUFFER_SIZE bytes. */
+const std::size_t MAX_READ_AHEAD_CHUNKS = 1024;
+/* Counts above it are a usage error, counts above the count of cores are lowered to it. */
+const std::size_t MAX_JOBS = 1024;
+
+
+struct Options {
+	std::size_t read_ahead_chunks;
+	std::size_t jobs;
+
+	Options() : read_ahead_chunks(0), jobs(1) {}
+};
+
+
+/*
+ * Parses the decimal count following prefix in argument. Anything but digits, or a count above maximum, is a usage error.
+ */
+std::size_t parse_count(const std::string& argument, const std::string& prefix, std::size_t maximum, const char* executable) {
+	std::size_t count = 0;
+
+	if (argument.size() == prefix.size()) throw CommandLineMissingArgumentsException(executable);
+	for (std::string::const_iterator digit = argument.cbegin() + prefix.size(), end = argument.cend(); digit != end; ++digit) {
+		if (*digit < '0' || *digit > '9') throw CommandLineMissingArgumentsException(executable);
+
+		count = count * 10 + (*digit - '0');
+		if (count > maximum) throw CommandLineMissingArgumentsException(executable);
+	}
+
+	return count;
+}
+
+
+/*
+ * Parses the optional arguments following <IN FILE> <OUT FILE>.
+ */
+Options parse_options(int argc, char* argv[]) {
+	const static std::string READ_AHEAD("--read-ahead=");
+	const static std::string JOBS("--jobs=");
+	Options options;
+
+	for (int index = 3; index < argc; ++index) {
+		std::string argument(argv[index]);
+
+		if (argument.compare(0, READ_AHEAD.size(), READ_AHEAD) == 0) options.read_ahead_chunks = parse_count(argument, READ_AHEAD, MAX_READ_AHEAD_CHUNKS, argv[0]);
+		else if (argument.compare(0, JOBS.size(), JOBS) == 0) options.jobs = parse_count(argument, JOBS, MAX_JOBS, argv[0]);
+		else throw CommandLineMissingArgumentsException(argv[0]);
+	}
+
+	if (options.jobs == 0) throw CommandLineMissingArgumentsException(argv[0]);
+
+	/* More jobs than cores only add segments to stitch. */
+	options.jobs = std::min<std::size_t>(options.jobs, std::max(1u, std::thread::hardware_concurrency()));
+	return options;
+}
+
+
+template<typename ScannerType> void parse(ScannerType* scanner, Parser* parser, bool* is_scan_valid) {
     std::cout << "Checking syntax..." << std::endl;
 
+    TokenBlock block;
+
     while(true) {
-        try {
-            Token token(scanner->next_token());
-
-            if(token.get_token_type() == TokenType::DEADBEEF) {
-                std::cerr << token << " - Unexpected character\n";
-                *is_scan_valid = false;
-            }
-            else parser->process(token);
-
-        } catch(const UnsupportedCharacterEncodingException& encoding_exception) {
-			std::cerr << encoding_exception.what() << std::endl;
-			*is_scan_valid = false;
-		}
+        std::size_t size = scanner->next_tokens(block);
+        parser->process(block);
+
+        switch(block.token_type(size - 1)) {
+        case TokenType::DEADBEEF:
+            std::cerr << scanner->get_line_index().locate(block.token(size - 1), scanner->get_symboltable()) << " - Unexpected character\n";
+            *is_scan_valid = false;
+            break;
+        case TokenType::UNSUPPORTED_CHARACTER:
+            std::cerr << scanner->get_line_index().locate(block.token(size - 1), scanner->get_symboltable()) << " - Unsupported character encoding, the required encoding is ASCII, or UTF-8 within comments\n";
+            *is_scan_valid = false;
+            break;
+        case TokenType::END_OF_FILE:
+            return;
+        default:
+            break;
+        }
     }
 }
 
 
-bool check_types(Parser* parser) {
+bool check_types(Parser* parser, LineIndex* line_index, const Symboltable* symboltable) {
     if(parser->finalize()) {
         std::cout << "\nChecking types..." << std::endl;
         ParseTree<Parser::TreeData>& parse_tree = parser->parse_tree();
 
-        return TypeCheck(&parse_tree, &std::cerr)();
+        return TypeCheck(&parse_tree, &std::cerr, line_index, symboltable)();
     }
 
     return false;
 }
 
 
+/*
+ * The tokens refer to the Symboltable of the scanner by keys, so it has to outlive the code generation. Its LineIndex locates the
+ * tokens in diagnostics.
+ */
+template<typename ScannerType> void compile(ScannerType* scanner, const Grammar& grammar, const char* out_file) {
+	Parser parser(grammar.rules(), &std::cerr, &scanner->get_line_index(), &scanner->get_symboltable());
+	bool is_scan_valid = true;
+
+	parse(scanner, &parser, &is_scan_valid);
+
+	if(check_types(&parser, &scanner->get_line_index(), &scanner->get_symboltable()) && is_scan_valid) {
+		std::cout << "\nGenerating code..." << std::endl;
+
+		std::ofstream out(out_file, std::ofstream::out | std::ofstream::trunc);
+		if (!out.is_open()) throw OutputFileFailureException(out_file);
+
+		MakeCode(&parser.parse_tree(), &out, &scanner->get_symboltable())();
+	}
+}
+
+
 int main(int argc, char* argv[]) {
 	try {
 		if (argc <3) throw CommandLineMissingArgumentsException(argv[0]);
@@ -59,22 +146,16 @@ int main(int argc, char* argv[]) {
 		std::cerr.tie(nullptr);
 
 		Grammar grammar(get_grammar_description());
-		Parser parser(grammar.rules(), &std::cerr);
-		Scanner scanner(argv[1]);
-		bool is_scan_valid = true;
+		Options options(parse_options(argc, argv));
 
-		try {
-            parse(&scanner, &parser, &is_scan_valid);
-		} catch(const BufferBoundsExceededException& end_of_file) {
-
-            if(check_types(&parser) && is_scan_valid) {
-                std::cout << "\nGenerating code..." << std::endl;
-
-                std::ofstream out(argv[2], std::ofstream::out | std::ofstream::trunc);
-                if (!out.is_open()) throw OutputFileFailureException(argv[2]);
-
-                MakeCode(&parser.parse_tree(), &out)();
-		    }
+		/* More than one job scans the whole file up front, so reading it ahead is pointless then. */
+		if (options.jobs > 1) {
+			ParallelScanner scanner(argv[1], options.jobs);
+			compile(&scanner, grammar, argv[2]);
+		}
+		else {
+			Scanner scanner(argv[1], options.read_ahead_chunks);
+			compile(&scanner, grammar, argv[2]);
 		}
 
 		return EXIT_SUCCESS_0;
@@ -10,12 +10,12 @@ const Token& MakeCode::get_token(const node_type& node) const {
 
 
 const String& MakeCode::get_lexem(const node_type& node) const {
-    return *this->get_token(node).value.information->lexem;
+    return this->get_token(node).get_lexem(*this->symboltable);
 }
 
 
 long MakeCode::get_integer(const node_type& node) const {
-    return this->get_token(node).value.integer;
+    return this->get_token(node).get_integer(*this->symboltable);
 }
 
 
@@ -38,7 +38,7 @@ String MakeCode::generate_label() const {
 FundamentalType MakeCode::get_data_type(const node_type& node) const {
     const Parser::TreeData& userdata = node.userdata();
 
-    if(userdata.is_token()) return userdata.token().get_data_type();
+    if(userdata.is_token()) return userdata.token().get_data_type(*this->symboltable);
     return node.get_data_type();
 }
 
@@ -256,7 +256,8 @@ void MakeCode::code_op(const node_type& op) const {
 }
 
 
-MakeCode::MakeCode(const ParseTree<Parser::TreeData>* parse_tree, std::ostream* code_stream) : parse_tree(parse_tree), code_stream(code_stream) {}
+MakeCode::MakeCode(const ParseTree<Parser::TreeData>* parse_tree, std::ostream* code_stream, const Symboltable* symboltable)
+    : parse_tree(parse_tree), code_stream(code_stream), symboltable(symboltable) {}
 
 
 void MakeCode::operator()() const {
@@ -0,0 +1,321 @@
+#include "parallel_scanner.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+/*
+ * The tokens of a segment scanned from one of both start states, and the state the scan ends in. Their offsets count from the begin
+ * of the segment. Tokens are buried in chunks that fill a grave of
+ * 64 KiB, so storing them neither copies them again nor allocates per token.
+ */
+struct ParallelScanner::Scan {
+	const static std::size_t CHUNK_SIZE = (1 << 16) / sizeof(Token) - 1;
+
+	Scanner* scanner;
+	BinaryGraveyard<Token> tokens;
+	Token chunk[Scan::CHUNK_SIZE];
+	std::size_t chunk_size;
+	Vector<TokenRange> ranges;
+	Token end_of_file;
+	bool ends_in_comment;
+	Vector<Symboltable::key_type> symbols;
+	Symboltable::key_type literal_base;
+
+	Scan(const char* begin, const char* end, bool in_comment)
+		: scanner(new Scanner(begin, end, in_comment)), tokens(), chunk_size(0), ranges(), end_of_file(), ends_in_comment(false)
+		, symbols(), literal_base(0) {}
+
+	~Scan() {
+		delete this->scanner;
+	}
+
+	Scan(const Scan& source) = delete;
+	Scan& operator=(const Scan& source) = delete;
+
+	void push_back(const Token& token) {
+		this->chunk[this->chunk_size++] = token;
+		if (this->chunk_size == Scan::CHUNK_SIZE) this->flush();
+	}
+
+	void flush() {
+		if (this->chunk_size != 0) this->tokens.bury(this->chunk, this->chunk_size);
+		this->chunk_size = 0;
+	}
+
+	void finish(const Token& end_of_file) {
+		this->flush();
+		this->ranges.push_back(TokenRange(this->tokens.begin(), this->tokens.end()));
+		this->end_of_file = end_of_file;
+		this->ends_in_comment = this->scanner->in_comment();
+	}
+
+	/*
+	 * Continues with the tokens of source, starting at synchronized.
+	 */
+	void finish(Scan& source, token_iterator synchronized) {
+		this->flush();
+		this->ranges.push_back(TokenRange(this->tokens.begin(), this->tokens.end()));
+		this->ranges.push_back(TokenRange(synchronized, source.tokens.end()));
+		this->end_of_file = source.end_of_file;
+		this->ends_in_comment = source.ends_in_comment;
+	}
+};
+
+/*
+ * A segment begins behind a line feed, so a Scanner starting on it is in the same state as one arriving from the previous segment,
+ * except for a comment spanning both. Only the scan from within a comment continues with the tokens of the scan from outside of one,
+ * starting at the synchronized token.
+ */
+struct ParallelScanner::Segment {
+	const char *begin, *end;
+	bool speculative, synchronized;
+	Scan *outside, *inside, *chosen;
+	std::uint32_t offset;
+	std::exception_ptr failure;
+
+	Segment(const char* begin, const char* end, bool speculative, std::uint32_t offset)
+		: begin(begin), end(end), speculative(speculative), synchronized(false), outside(nullptr), inside(nullptr), chosen(nullptr)
+		, offset(offset), failure() {}
+
+	~Segment() {
+		delete this->outside;
+		delete this->inside;
+	}
+
+	Segment(const Segment& source) = delete;
+	Segment& operator=(const Segment& source) = delete;
+};
+
+ParallelScanner::ParallelScanner(const String& file, std::size_t jobs)
+	: source(file, 0, 0, ParallelScanner::MINIMUM_SEGMENT_SIZE), symboltable(nullptr), segments(), ranges(), active_range(0), end_of_file() {
+	this->source.mark();
+	do this->source.skip_to(this->source.pending_end());
+	while (this->source.get() != Buffer::END_OF_SOURCE);
+
+	this->split(this->source.marked(), this->source.pending_end(), jobs);
+	this->for_each_segment(&ParallelScanner::scan_segment);
+	this->stitch();
+	this->for_each_segment([this](Segment* segment) { this->relocate(segment); });
+}
+
+ParallelScanner::~ParallelScanner() {
+	for (Vector<Segment*>::iterator iterator = this->segments.begin(), end = this->segments.end(); iterator != end; ++iterator) delete *iterator;
+}
+
+/*
+ * Splits [begin, end) behind the line feeds next to equal shares, but keeps segments from getting smaller than MINIMUM_SEGMENT_SIZE.
+ */
+void ParallelScanner::split(const char* begin, const char* end, std::size_t jobs) {
+	std::size_t size = end - begin;
+	std::size_t count = std::max<std::size_t>(1, std::min<std::size_t>(jobs, size / ParallelScanner::MINIMUM_SEGMENT_SIZE));
+	const char* segment_begin = begin;
+
+	for (std::size_t index = 1; index < count; index++) {
+		const char* segment_end = std::find(std::max(segment_begin, begin + (size / count) * index), end, '\n');
+		if (segment_end == end) break;
+
+		this->segments.push_back(new Segment(segment_begin, ++segment_end, this->segments.size() != 0, segment_begin - begin));
+		segment_begin = segment_end;
+	}
+
+	this->segments.push_back(new Segment(segment_begin, end, this->segments.size() != 0, segment_begin - begin));
+}
+
+/*
+ * Calls function for every segment, each on its own thread. Rethrows the first exception of a segment, once all threads are done.
+ */
+template<typename Function> void ParallelScanner::for_each_segment(Function function) {
+	auto guarded = [function](Segment* segment) {
+		try {
+			function(segment);
+		} catch(...) {
+			segment->failure = std::current_exception();
+		}
+	};
+
+	/* Joins every started thread on leaving the scope, also if starting a later one throws. */
+	struct Workers {
+		Vector<std::thread> threads;
+
+		~Workers() {
+			for (Vector<std::thread>::iterator thread = this->threads.begin(), end = this->threads.end(); thread != end; ++thread) {
+				if (thread->joinable()) thread->join();
+			}
+		}
+	};
+
+	std::size_t count = this->segments.size();
+
+	{
+		Workers workers;
+		workers.threads.reserve(count - 1);
+
+		for (std::size_t index = 1; index < count; index++) workers.threads.emplace_back(guarded, this->segments[index]);
+		guarded(this->segments[0]);
+	}
+
+	for (std::size_t index = 0; index < count; index++) {
+		if (this->segments[index]->failure) std::rethrow_exception(this->segments[index]->failure);
+	}
+}
+
+void ParallelScanner::scan(Scan* scan) {
+	while (true) {
+		Token token = scan->scanner->next_token();
+
+		if (token.get_token_type() == TokenType::END_OF_FILE) {
+			scan->finish(token);
+			return;
+		}
+
+		scan->push_back(token);
+	}
+}
+
+/*
+ * A token other than an error token is located at the start of its lexem, which the Scanner began in the start state. So once both
+ * scans yield the same such token at the same offset, they go on alike. The error tokens of a lexem precede it, so both scans have
+ * their own.
+ */
+void ParallelScanner::scan_segment(Segment* segment) {
+	segment->outside = new Scan(segment->begin, segment->end, false);
+	ParallelScanner::scan(segment->outside);
+
+	if (!segment->speculative) return;
+
+	Scan* inside = segment->inside = new Scan(segment->begin, segment->end, true);
+	token_iterator index = segment->outside->tokens.begin(), outside_end = segment->outside->tokens.end();
+
+	while (true) {
+		Token token = inside->scanner->next_token();
+		TokenType token_type = token.get_token_type();
+
+		if (token_type == TokenType::END_OF_FILE) {
+			inside->finish(token);
+			return;
+		}
+
+		if (token_type != TokenType::UNSUPPORTED_CHARACTER) {
+			while (index != outside_end && ((*index).offset < token.offset || (*index).get_token_type() == TokenType::UNSUPPORTED_CHARACTER)) ++index;
+
+			if (index != outside_end && (*index).offset == token.offset && (*index).get_token_type() == token_type) {
+				segment->synchronized = true;
+				inside->finish(*segment->outside, index);
+				return;
+			}
+		}
+
+		inside->push_back(token);
+	}
+}
+
+/*
+ * Picks the scan of every segment from left to right. The Symboltable of the first segment collects the symbols and the pooled literals
+ * of the picked scans, so its tokens are final already. Every scan remembers the keys its symbols and literals got there.
+ */
+void ParallelScanner::stitch() {
+	bool in_comment = false;
+
+	this->symboltable = &(*this->segments.begin())->outside->scanner->get_symboltable();
+
+	for (Vector<Segment*>::iterator iterator = this->segments.begin(), end = this->segments.end(); iterator != end; ++iterator) {
+		Segment* segment = *iterator;
+
+		segment->chosen = in_comment ? segment->inside : segment->outside;
+		in_comment = segment->chosen->ends_in_comment;
+
+		if (!segment->speculative) continue;
+
+		Vector<Scan*> scans;
+		scans.push_back(segment->chosen);
+		if (segment->chosen == segment->inside && segment->synchronized) scans.push_back(segment->outside);
+
+		for (Vector<Scan*>::iterator scan = scans.begin(), scans_end = scans.end(); scan != scans_end; ++scan) {
+			Symboltable& symboltable = (*scan)->scanner->get_symboltable();
+			for (Information& information : symboltable) (*scan)->symbols.push_back(this->symboltable->insert(Lexeme(*information.lexem), information.token_type));
+
+			(*scan)->literal_base = static_cast<Symboltable::key_type>(this->symboltable->pooled_literals());
+			for (std::size_t literal = 0; literal < symboltable.pooled_literals(); literal++) {
+				this->symboltable->insert_literal(symboltable.lookup_literal(static_cast<Symboltable::key_type>(literal) | Symboltable::POOLED_LITERAL));
+			}
+		}
+	}
+
+	for (Vector<Segment*>::iterator iterator = this->segments.begin(), end = this->segments.end(); iterator != end; ++iterator) {
+		const Vector<TokenRange>& ranges = (*iterator)->chosen->ranges;
+		for (Vector<TokenRange>::const_iterator range = ranges.cbegin(), ranges_end = ranges.cend(); range != ranges_end; ++range) this->ranges.push_back(*range);
+	}
+
+	const Segment* last = *(this->segments.end() - 1);
+	this->end_of_file = last->chosen->end_of_file;
+	this->end_of_file.offset += last->offset;
+}
+
+/*
+ * Moves the tokens of the picked scan behind the previous segments, and lets them refer to the collected symbols and literals, so
+ * identical identifiers share their symbol again. The second range of a scan holds tokens of the scan from outside of a comment.
+ * Afterwards the Scanners of the segment are gone.
+ */
+void ParallelScanner::relocate(Segment* segment) {
+	if (!segment->speculative) return;
+
+	Scan* chosen = segment->chosen;
+
+	for (std::size_t index = 0; index < chosen->ranges.size(); index++) {
+		const Scan* origin = index == 0 ? chosen : segment->outside;
+		TokenRange& range = chosen->ranges[index];
+
+		for (token_iterator token = range.begin; token != range.end; ++token) {
+			(*token).offset += segment->offset;
+
+			TokenType token_type = (*token).get_token_type();
+			if (token_type == TokenType::IDENTIFIER || token_type == TokenType::OUT_OF_RANGE_INTEGER) {
+				(*token).value.symbol = origin->symbols[(*token).value.symbol];
+			}
+			else if (token_type == TokenType::INTEGER && ((*token).value.literal & Symboltable::POOLED_LITERAL)) {
+				(*token).value.literal += origin->literal_base;
+			}
+		}
+	}
+
+	if (chosen == segment->outside) {
+		delete segment->inside;
+		segment->inside = nullptr;
+	}
+
+	delete segment->outside->scanner;
+	segment->outside->scanner = nullptr;
+	if (segment->inside) {
+		delete segment->inside->scanner;
+		segment->inside->scanner = nullptr;
+	}
+}
+
+const Token& ParallelScanner::scan_token() {
+	while (this->active_range < this->ranges.size()) {
+		TokenRange& range = this->ranges[this->active_range];
+		if (range.begin != range.end) return *(range.begin++);
+
+		this->active_range++;
+	}
+
+	return this->end_of_file;
+}
+
+Token ParallelScanner::next_token() {
+	return this->scan_token();
+}
+
+std::size_t ParallelScanner::next_tokens(TokenBlock& block) {
+	block.clear();
+
+	while (!block.full()) {
+		const Token& token = this->scan_token();
+		block.push_back(token);
+
+		TokenType token_type = token.get_token_type();
+		if (token_type == TokenType::DEADBEEF || token_type == TokenType::UNSUPPORTED_CHARACTER || token_type == TokenType::END_OF_FILE) break;
+	}
+
+	return block.size();
+}
@@ -119,6 +119,7 @@ bool Parser::stack_push_rule(Grammar::Variable variable, TokenType type) {
     const Vector<Grammar::Value>& production = this->lookup_table[lookup_table_index];
 
     if(type != TokenType::EPSILON || production.size() != 0) {
+        this->active_node->reserve_children(production.size());
         this->stack.push_back(production);
         return true;
     }
@@ -199,7 +200,7 @@ bool Parser::is_epsilon_replaceable(const Vector<Grammar::Value>& production_rul
 
 void Parser::write_error_message(const Token& token, const Vector<TokenType>& expected) const {
     if(token.get_token_type() == TokenType::EPSILON) *this->error_stream << "Unexpected end of file\nExpected: ";
-    else *this->error_stream << token << " - Unexpected token\nExpected: ";
+    else *this->error_stream << this->line_index->locate(token, *this->symboltable) << " - Unexpected token\nExpected: ";
 
     for(Vector<TokenType>::const_iterator expected_iterator = expected.cbegin(), expected_end_iterator = expected.cend(); expected_iterator < expected_end_iterator - 1; ++expected_iterator) {
         *this->error_stream << (*expected_iterator) << ", ";
@@ -218,9 +219,9 @@ void Parser::write_error_message(const Token& token, const Vector<TokenType>& ex
 }
 
 
-Parser::Parser(const Vector<Grammar::Rule>& rules, std::ostream* error_stream)
+Parser::Parser(const Vector<Grammar::Rule>& rules, std::ostream* error_stream, LineIndex* line_index, const Symboltable* symboltable)
     : tree(), branch_matrix(static_cast<std::size_t>(Grammar::Terminal::ENUM_ENTRY_COUNT), rules.size(), Parser::INVALID_RULE_REFERENCE_ID), lookup_table(), stack()
-    , active_node(&this->tree.root()), error_stream(error_stream), recovery(false), valid(true) {
+    , active_node(&this->tree.root()), error_stream(error_stream), line_index(line_index), symboltable(symboltable), recovery(false), valid(true) {
 
     if(rules.size() == 0) throw NoStartStateException("Parser::Parser(const Vector<Grammar::Rule>&)");
 
@@ -251,9 +252,12 @@ bool Parser::process(const Token& token) {
             Grammar::Value value = this->stack_rule_pop();
             this->active_node = &(this->active_node->create_child(value.variable()));
 
-            if (!this->stack_push_rule(value.variable(), type) && this->stack_peek().size()) {
+            /*
+             * An epsilon production pushes no frame, so its node is left right away, even if cleanup_stack() leaves its parent next.
+             */
+            if(!this->stack_push_rule(value.variable(), type)) {
                 this->active_node = &(this->active_node->parent());
-		return true;
+                if(this->stack_peek().size()) return true;
             }
         }
         else {
@@ -264,8 +268,21 @@ bool Parser::process(const Token& token) {
 }
 
 
+bool Parser::process(const TokenBlock& block) {
+    const TokenType* types = block.token_types();
+    bool valid = true;
+
+    for(std::size_t index = 0, size = block.size(); index < size; index++) {
+        TokenType type = types[index];
+        if(type != TokenType::DEADBEEF && type != TokenType::UNSUPPORTED_CHARACTER && type != TokenType::END_OF_FILE) valid = this->process(block.token(index)) && valid;
+    }
+
+    return valid;
+}
+
+
 bool Parser::finalize() {
-    const static Token DUMMY_TOKEN(0, 0, TokenType::EPSILON);
+    const static Token DUMMY_TOKEN(0, TokenType::EPSILON);
 
     this->error_stream->flush();
 
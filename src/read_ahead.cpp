@@ -0,0 +1,87 @@
+#include "read_ahead.h"
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+ReadAhead::ReadAhead(int source, std::size_t chunk_count, std::size_t chunk_size)
+	: source(source), chunk_count(chunk_count), chunk_size(chunk_size), chunks(new Chunk[chunk_count]), produced(0), consumed(0), stopped(false), exhausted(false) {
+
+	for (std::size_t index = 0; index < this->chunk_count; index++) {
+		this->chunks[index].data = static_cast<char*>(::operator new[](this->chunk_size));
+		this->chunks[index].size = 0;
+	}
+
+	this->reader = std::thread(&ReadAhead::run, this);
+}
+
+/*
+ * Spins SPIN_COUNT times for ready() to hold, then sleeps on condition until the other side notifies it.
+ */
+template<typename Predicate> void ReadAhead::await(std::condition_variable& condition, Predicate ready) {
+	for (std::size_t spin = 0; spin < ReadAhead::SPIN_COUNT; spin++) {
+		if (ready()) return;
+		std::this_thread::yield();
+	}
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	condition.wait(lock, ready);
+}
+
+/*
+ * Taking the mutex orders the preceding store before the check of a side about to sleep, so no wakeup is lost.
+ */
+void ReadAhead::notify(std::condition_variable& condition) {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+	}
+	condition.notify_one();
+}
+
+/*
+ * Producer side: fills free chunks until the source is exhausted, failed or the consumer is destructed.
+ */
+void ReadAhead::run() {
+	std::size_t produced = this->produced.load(std::memory_order_relaxed);
+
+	while (true) {
+		this->await(this->chunk_consumed, [this, produced]() {
+			return this->stopped.load(std::memory_order_relaxed) || produced - this->consumed.load(std::memory_order_acquire) != this->chunk_count;
+		});
+		if (this->stopped.load(std::memory_order_relaxed)) return;
+
+		Chunk& chunk = this->chunks[produced % this->chunk_count];
+		do {
+			chunk.size = ::read(this->source, chunk.data, this->chunk_size);
+		} while (chunk.size < 0 && errno == EINTR);
+
+		this->produced.store(++produced, std::memory_order_release);
+		this->notify(this->chunk_produced);
+
+		if (chunk.size <= 0) return;
+	}
+}
+
+std::ptrdiff_t ReadAhead::read(char* destination) {
+	if (this->exhausted) return 0;
+
+	std::size_t consumed = this->consumed.load(std::memory_order_relaxed);
+	this->await(this->chunk_produced, [this, consumed]() { return this->produced.load(std::memory_order_acquire) != consumed; });
+
+	const Chunk& chunk = this->chunks[consumed % this->chunk_count];
+	std::ptrdiff_t size = chunk.size;
+	if (size > 0) std::copy(chunk.data, chunk.data + size, destination);
+	else this->exhausted = true;
+
+	this->consumed.store(consumed + 1, std::memory_order_release);
+	this->notify(this->chunk_consumed);
+	return size;
+}
+
+ReadAhead::~ReadAhead() {
+	this->stopped.store(true, std::memory_order_relaxed);
+	this->notify(this->chunk_consumed);
+	this->reader.join();
+
+	for (std::size_t index = 0; index < this->chunk_count; index++) ::operator delete[](this->chunks[index].data);
+	delete[] this->chunks;
+}
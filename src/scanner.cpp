@@ -4,300 +4,367 @@
 #include "buffer.h"
 #include "exception.h"
 #include "scanner.h"
+#include "scanner_tables.h"
+#include <limits>
 
-FiniteStateMachine init_finite_state_machine(const std::function<void(Direction, char)>& line_count_callback) {
-
-	// Identifier States and Transitions
-	static FinalState identifier_final(TokenType::IDENTIFIER);
-
-	static TypeTransition to_identifier_final_by_alpha_numeric(&identifier_final, CharClass::ALPHA_NUMERIC);
-	identifier_final.add(&to_identifier_final_by_alpha_numeric);
-
-	static TypeTransition to_identifier_final_by_alpha(&identifier_final, CharClass::ALPHA);
-	identifier_final.add(&to_identifier_final_by_alpha);
-
-	// Number States and Transitions
-	static FinalState integer_final(TokenType::INTEGER);
-
-	static TypeTransition to_integer_final_by_numeric(&integer_final, CharClass::NUMERIC);
-	integer_final.add(&to_integer_final_by_numeric);
-
-	// Plus States and Transitions
-	static FinalState plus_final(TokenType::PLUS);
-
-	static CharTransition to_plus_final_by_plus(&plus_final, '+');
-
-	// Minus States and Transitions
-	static FinalState minus_final(TokenType::MINUS);
-
-	static CharTransition to_minus_final_by_minus(&minus_final, '-');
-
-	// Comment States and Transitions (Depends upon Colon States and Transitions and serves as dependency for Linefeed States and Transitions within Comments)
-	static FinalState comment_entry(TokenType::COMMENT);
-
-	static TypeTransition to_comment_entry_by_any(&comment_entry, CharClass::ANY);
-	comment_entry.add(&to_comment_entry_by_any);
-
-	static CharTransition to_comment_entry_by_asterisk(&comment_entry, '*');
-
-
-	static FinalState comment_exit(TokenType::COMMENT, &to_comment_entry_by_any);
-
-	static CharTransition to_comment_exit_by_asterisk(&comment_exit, '*');
-	comment_entry.add(&to_comment_exit_by_asterisk);
-
-
-	static FinalState comment_final(TokenType::COMMENT);
-
-	static CharTransition to_comment_final_by_colon(&comment_final, ':');
-	comment_exit.add(&to_comment_final_by_colon);
+/*
+ * The automaton is immutable, so all Scanners share one instance. Initialization of function-local statics is thread safe.
+ */
+static const FiniteStateMachine& scanner_finite_state_machine() {
+	static const FiniteStateMachine finite_state_machine(SCANNER_TABLES);
+	return finite_state_machine;
+}
 
-	// Linefeed States and Transitions within Comments (Depens upon Comment States and Transitions and serves as dependency for Comment States and Transitions)
+Scanner::Scanner(const String& file, std::size_t read_ahead_chunks)
+	: cursor(scanner_finite_state_machine()), symboltable()
+	, buffer(file, scanner_finite_state_machine().get_max_steps_since_last_final_state(), read_ahead_chunks), lexem_size(0), lexem_offset(0), integer(0), integer_digits(0), integer_overflow(false), lexem_hash(0), hashed_size(0), interrupted_lexem(), token(), pending_exception() {}
 
-	static CallbackFinalState comment_mac_line_feed_final(TokenType::COMMENT, &to_comment_entry_by_any, line_count_callback);
+Scanner::Scanner(const char* begin, const char* end, bool in_comment)
+	: cursor(scanner_finite_state_machine()), symboltable()
+	, buffer(begin, end), lexem_size(0), lexem_offset(0), integer(0), integer_digits(0), integer_overflow(false), lexem_hash(0), hashed_size(0), interrupted_lexem(), token(), pending_exception() {
+	if (in_comment) this->enter_comment();
+}
 
-	comment_mac_line_feed_final.add(&to_comment_exit_by_asterisk);
+/*
+ * Starts the first lexem as a comment, as if its opening ":*" had been processed, and consumes as much of it as possible. So the lexem
+ * is only empty, if the first byte can't continue the comment, which excludes blanks, thus scan_token() doesn't skip them.
+ */
+void Scanner::enter_comment() {
+	this->buffer.mark();
+	this->cursor.process(':');
+	this->cursor.process('*');
+	this->process_run();
+}
 
-	static CharTransition to_comment_mac_line_feed_final_by_carriage_return(&comment_mac_line_feed_final, '\r');
-	comment_mac_line_feed_final.add(&to_comment_mac_line_feed_final_by_carriage_return);
-	comment_entry.add(&to_comment_mac_line_feed_final_by_carriage_return);
-	comment_exit.add(&to_comment_mac_line_feed_final_by_carriage_return);
+/*
+ * Consumes the run of bytes the current state loops on, if it has a SkipKernel.
+ */
+void Scanner::skip_loop() {
+	SkipKernel skip_kernel = this->cursor.get_skip_kernel();
 
+	if (skip_kernel == SkipKernel::DIGIT) this->accumulate_integer();
+	else if (skip_kernel == SkipKernel::ALPHA_NUMERIC) this->accumulate_hash();
+	else if (skip_kernel != SkipKernel::NONE) this->skip_run(skip_kernel);
+}
 
-	static CallbackFinalState comment_unix_line_feed_final(TokenType::COMMENT, &to_comment_entry_by_any, line_count_callback);
+/*
+ * Feeds the FiniteStateMachine the pending bytes in a single call, up to the byte crashing it. That byte is left to scan_token(), which
+ * handles the end of the lexem and unsupported bytes, as well as the newline injected at the end of the file.
+ */
+void Scanner::process_run() {
+	const char* begin = this->buffer.pending_begin();
+	const char* end = this->cursor.process(begin, this->buffer.pending_end());
 
-	static CharTransition to_comment_unix_line_feed_final_by_line_feed(&comment_mac_line_feed_final, '\n');
-	comment_mac_line_feed_final.add(&to_comment_unix_line_feed_final_by_line_feed);
-	comment_entry.add(&to_comment_unix_line_feed_final_by_line_feed);
-	comment_exit.add(&to_comment_unix_line_feed_final_by_line_feed);
-	comment_unix_line_feed_final.add(&to_comment_unix_line_feed_final_by_line_feed);
+	if (end == begin) return;
 
-	comment_unix_line_feed_final.add(&to_comment_exit_by_asterisk);
-	comment_unix_line_feed_final.add(&to_comment_mac_line_feed_final_by_carriage_return);
+	this->lexem_size += end - begin;
+	this->buffer.skip_to(end);
+	this->skip_loop();
+}
 
-	// Assignment States and Transitions (Depends upon Colon States and Transitions)
-	static FinalState assignment_final(TokenType::ASSIGNMENT);
+void Scanner::reset_integer() {
+	this->integer = 0;
+	this->integer_digits = 0;
+	this->integer_overflow = false;
+}
 
-	static CharTransition to_assignment_final_by_equal(&assignment_final, '=');
+static const unsigned long INTEGER_MAXIMUM = std::numeric_limits<long>::max();
 
-	// Colon States and Transitions (Serves as dependency for Assignment and Comment States and Transitions)
-	static FinalState colon_final(TokenType::COLON, {&to_assignment_final_by_equal, &to_comment_entry_by_asterisk});
+/*
+ * POWERS_OF_TEN[n] shifts a value by n digits. Any n further digits take a value above SHIFT_LIMITS[n] out of range, so the overflow flag
+ * sticks before the unsigned accumulator can wrap.
+ */
+static const unsigned long POWERS_OF_TEN[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+static const unsigned long SHIFT_LIMITS[9] = {
+	INTEGER_MAXIMUM, INTEGER_MAXIMUM / 10, INTEGER_MAXIMUM / 100, INTEGER_MAXIMUM / 1000, INTEGER_MAXIMUM / 10000,
+	INTEGER_MAXIMUM / 100000, INTEGER_MAXIMUM / 1000000, INTEGER_MAXIMUM / 10000000, INTEGER_MAXIMUM / 100000000
+};
 
-	static CharTransition to_colon_final_by_colon(&colon_final, ':');
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && __SIZEOF_LONG__ == 8
+/*
+ * Converts 8 digit values, loaded in memory order and already stripped of '0', in three multiplications.
+ */
+static inline unsigned long eight_digits_value(unsigned long digits) {
+	digits = (digits * 10) + (digits >> 8);
+	return (((digits & 0x000000FF000000FF) * (100 + (1000000UL << 32))) + (((digits >> 16) & 0x000000FF000000FF) * (1 + (10000UL << 32)))) >> 32;
+}
+#endif
 
-	// Asterisk States and Transitions
-	static FinalState asterisk_final(TokenType::ASTERISK);
+/*
+ * Accumulates the value of the digits in [begin, end) into the integer. Bytes up to readable_end may be loaded, which lets the last
+ * digits of the run be converted as one chunk padded with leading zeros, so the conversion doesn't branch on the length of the run.
+ * Works on locals, because stores through the members could alias the bytes read.
+ */
+void Scanner::accumulate_integer(const char* begin, const char* end, const char* readable_end) {
+	unsigned long integer = this->integer;
+	bool overflow = this->integer_overflow;
 
-	static CharTransition to_asterisk_final_by_asterisk(&asterisk_final, '*');
+	this->integer_digits += end - begin;
 
-	// Less Than States and Transitions
-	static FinalState less_than_final(TokenType::LESS_THAN);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && __SIZEOF_LONG__ == 8
+	const unsigned long ZEROS = 0x3030303030303030;
+	unsigned long chunk;
 
-	static CharTransition to_less_than_final_by_less_than(&less_than_final, '<');
+	for (; end - begin >= 8; begin += 8) {
+		__builtin_memcpy(&chunk, begin, 8);
+		overflow |= integer > SHIFT_LIMITS[8];
+		integer = integer * POWERS_OF_TEN[8] + eight_digits_value(chunk - ZEROS);
+	}
 
-	// Greater Than States and Transitions
-	static FinalState greater_than_final(TokenType::GREATER_THAN);
+	std::size_t size = end - begin;
+	if (size != 0 && readable_end - begin >= 8) {
+		__builtin_memcpy(&chunk, begin, 8);
+		overflow |= integer > SHIFT_LIMITS[size];
+		integer = integer * POWERS_OF_TEN[size] + eight_digits_value((chunk - ZEROS) << ((8 - size) * 8));
+		begin = end;
+	}
+#endif
 
-	static CharTransition to_greater_than_final_by_greater_than(&greater_than_final, '>');
+	for (; begin != end; ++begin) {
+		overflow |= integer > SHIFT_LIMITS[1];
+		integer = integer * 10 + static_cast<unsigned long>(*begin - '0');
+	}
 
-	// Whatever States and Transitions (Depends upon Equality States and Transitions)
-	static FinalState whatever_final(TokenType::WHATEVER);
+	this->integer = integer;
+	this->integer_overflow = overflow;
+}
 
-	static CharTransition to_whatever_final_by_equal(&whatever_final, '=');
-	static State whatever_non_final(&to_whatever_final_by_equal);
+/*
+ * Called whenever the FiniteStateMachine consumed a digit into a state looping on digits. Consumes the run of digits behind it, and
+ * accumulates the integer value of the digit and the run, so the value and its overflow are known once the lexem ends.
+ */
+void Scanner::accumulate_integer() {
+	const char* begin = this->buffer.pending_begin();
+	const char* end = ::skip_run(SkipKernel::DIGIT, begin, this->buffer.pending_end());
 
-	static CharTransition to_whatever_non_final_by_colon(&whatever_non_final, ':');
+	this->accumulate_integer(begin - 1, end, this->buffer.pending_end());
+	this->lexem_size += end - begin;
+	this->buffer.skip_to(end);
+}
 
-	// Equality States and Transitions (Serves as dependency for Whatever States and Transitions)
-	static FinalState equality_final(TokenType::EQUALITY, &to_whatever_non_final_by_colon);
+Token* Scanner::make_integer_token(const Lexeme& lexem) {
+	if (this->integer_digits != lexem.size()) {
+		this->reset_integer();
+		this->accumulate_integer(lexem.cbegin(), lexem.cend(), lexem.cend());
+	}
 
-	static CharTransition to_equality_final_by_equal(&equality_final, '=');
+	if (this->integer_overflow || this->integer > INTEGER_MAXIMUM) {
+		Symboltable::key_type symbol = this->symboltable.insert(lexem, TokenType::OUT_OF_RANGE_INTEGER);
+		return &(this->token = Token(this->lexem_offset, TokenType::OUT_OF_RANGE_INTEGER, symbol));
+	}
 
-	// Logical Not States and Transitions
-	static FinalState logical_not_final(TokenType::NOT);
+	Symboltable::key_type literal = this->symboltable.insert_literal(static_cast<long>(this->integer));
+	return &(this->token = Token(this->lexem_offset, TokenType::INTEGER, literal));
+}
 
-	static CharTransition to_logical_not_final_by_exclamation_mark(&logical_not_final, '!');
+void Scanner::reset_hash() {
+	this->lexem_hash = 0;
+	this->hashed_size = 0;
+}
 
-	// Semicolon States and Transitions
-	static FinalState semicolon_final(TokenType::SEMICOLON);
+/*
+ * Called whenever the FiniteStateMachine consumed a byte into the state looping on identifier bytes. Consumes the run behind it, and
+ * mixes the whole words of the lexem not hashed yet into its hash, including those in front of the state, while they are still cached.
+ */
+void Scanner::accumulate_hash() {
+	const char* begin = this->buffer.pending_begin();
+	const char* end = ::skip_run(SkipKernel::ALPHA_NUMERIC, begin, this->buffer.pending_end());
+	const char* hashed = this->buffer.marked() + this->hashed_size;
+	std::size_t words = (end - hashed) / HASH_WORD_SIZE;
+
+	this->lexem_hash = hash_words(this->lexem_hash, hashed, words);
+	this->hashed_size += words * HASH_WORD_SIZE;
+	this->lexem_size += end - begin;
+	this->buffer.skip_to(end);
+}
 
-	static CharTransition to_semicolon_final_by_semicolon(&semicolon_final, ';');
+/*
+ * Finishes the hash with the bytes behind the hashed words. Identifiers, which the automaton backtracked into hashed words, or which
+ * were interrupted by invalid bytes, are hashed here entirely.
+ */
+Token* Scanner::make_identifier_token(const Lexeme& lexem) {
+	bool hashed = this->hashed_size <= lexem.size() && this->interrupted_lexem.size() == 0;
+	std::size_t hash = hashed ? finish_hash(this->lexem_hash, lexem.cbegin() + this->hashed_size, lexem.cend(), lexem.size()) : std::hash<Lexeme>()(lexem);
 
-	// Parenthesis Open States and Transitions
-	static FinalState parenthesis_open_final(TokenType::PARENTHESIS_OPEN);
+	Symboltable::key_type symbol = this->symboltable.insert(lexem, hash, TokenType::IDENTIFIER);
+	return &(this->token = Token(this->lexem_offset, TokenType::IDENTIFIER, symbol));
+}
 
-	static CharTransition to_parenthesis_open_final_by_parenthesis_open(&parenthesis_open_final, '(');
+/*
+ * Blanks in front of a token never reach the FiniteStateMachine, they'd only crash it in the start state.
+ */
+void Scanner::skip_blanks() {
+	this->buffer.skip_to(::skip_run(SkipKernel::BLANK, this->buffer.pending_begin(), this->buffer.pending_end()));
+}
 
-	// Parenthesis Close States and Transitions
-	static FinalState parenthesis_close_final(TokenType::PARENTHESIS_CLOSE);
+/*
+ * Consumes the run of bytes the current state loops on, as if each of them had been processed.
+ */
+void Scanner::skip_run(SkipKernel skip_kernel) {
+	const char* begin = this->buffer.pending_begin();
+	const char* end = ::skip_run(skip_kernel, begin, this->buffer.pending_end());
 
-	static CharTransition to_parenthesis_close_final_by_parenthesis_close(&parenthesis_close_final, ')');
+	this->lexem_size += end - begin;
+	this->buffer.skip_to(end);
+}
 
-	// Curly Bracket Open States and Transitions
-	static FinalState curly_bracket_open_final(TokenType::CURLY_BRACKET_OPEN);
+/*
+ * The lexem consists of the bytes from the Buffer's mark on. Only if invalid bytes interrupted it, the bytes in front of them are moved
+ * into interrupted_lexem, because the lexem continues behind them. The invalid bytes are the last invalid_size bytes consumed.
+ */
+void Scanner::interrupt_lexem(std::size_t invalid_size) {
+	this->interrupted_lexem.append(this->buffer.marked(), this->buffer.pending_begin() - invalid_size);
+	this->buffer.mark();
+	this->reset_hash();
+}
 
-	static CharTransition to_curly_bracket_open_final_by_curly_bracket_open(&curly_bracket_open_final, '{');
+bool Scanner::in_comment() const {
+	return this->cursor.get_last_final_token() == TokenType::COMMENT;
+}
 
-	// Curly Bracket Close States and Transitions
-	static FinalState curly_bracket_close_final(TokenType::CURLY_BRACKET_CLOSE);
+/*
+ * Only comments take non-ASCII bytes, and all of their states are final. So pending steps behind a comment belong to an UTF-8 sequence,
+ * which the next byte can't continue.
+ */
+bool Scanner::in_utf8_sequence(std::size_t pending_size) const {
+	return pending_size != 0 && this->in_comment();
+}
 
-	static CharTransition to_curly_bracket_close_final_by_curly_bracket_close(&curly_bracket_close_final, '}');
+/*
+ * Invalid bytes within a comment stay part of it. They are the last invalid_size bytes consumed, reported by a single error token, and
+ * the comment resumes in the state in front of them.
+ */
+const Token& Scanner::skip_invalid_comment_bytes(std::size_t invalid_size) {
+	const char* invalid = this->buffer.pending_begin() - invalid_size;
 
-	// Square Bracket Open States and Transitions
-	static FinalState square_bracket_open_final(TokenType::SQUARE_BRACKET_OPEN);
+	this->cursor.resume_last_final_state();
+	return this->token = Token(this->buffer.offset(invalid), *invalid, TokenType::UNSUPPORTED_CHARACTER);
+}
 
-	static CharTransition to_square_bracket_open_final_by_square_bracket_open(&square_bracket_open_final, '[');
+Token Scanner::next_token() {
+	return this->scan_token();
+}
 
-	// Square Bracket Close States and Transitions
-	static FinalState square_bracket_close_final(TokenType::SQUARE_BRACKET_CLOSE);
+std::size_t Scanner::next_tokens(TokenBlock& block) {
+	block.clear();
 
-	static CharTransition to_square_bracket_close_final_by_square_bracket_close(&square_bracket_close_final, ']');
+	if (this->pending_exception) {
+		std::exception_ptr pending_exception = this->pending_exception;
+		this->pending_exception = nullptr;
+		std::rethrow_exception(pending_exception);
+	}
 
-	// Logical And States and Transitions
-	static FinalState logical_and_final(TokenType::LOGICAL_AND);
+	try {
+		while (!block.full()) {
+			const Token& token = this->scan_token();
+			block.push_back(token);
 
-	static CharTransition to_logical_and_final_by_and(&logical_and_final, '&');
-	static State logical_and_non_final(&to_logical_and_final_by_and);
+			TokenType token_type = token.get_token_type();
+			if (token_type == TokenType::DEADBEEF || token_type == TokenType::UNSUPPORTED_CHARACTER || token_type == TokenType::END_OF_FILE) break;
+		}
+	} catch(...) {
+		if (block.size() == 0) throw;
+		this->pending_exception = std::current_exception();
+	}
 
-	static CharTransition to_logical_and_non_final_by_and(&logical_and_non_final, '&');
+	return block.size();
+}
 
-	// Linefeed States and Transitions
-	static CallbackFinalState mac_line_feed_final(TokenType::LINE_FEED, line_count_callback);
+const Token& Scanner::scan_token() {
 
-	static CharTransition to_mac_line_feed_final_by_carriage_return(&mac_line_feed_final, '\r');
-	mac_line_feed_final.add(&to_mac_line_feed_final_by_carriage_return);
+	while (true) {
+		if (this->lexem_size == 0) {
+			this->skip_blanks();
+			this->buffer.mark();
+			this->reset_integer();
+			this->reset_hash();
+			this->lexem_offset = this->buffer.offset(this->buffer.marked());
+		}
 
+		this->process_run();
 
-	static CallbackFinalState unix_line_feed_final(TokenType::LINE_FEED, &to_mac_line_feed_final_by_carriage_return, line_count_callback);
+		int current = this->buffer.get();
 
-	static CharTransition to_unix_line_feed_final_by_new_line(&unix_line_feed_final, '\n');
-	unix_line_feed_final.add(&to_unix_line_feed_final_by_new_line);
-	mac_line_feed_final.add(&to_unix_line_feed_final_by_new_line);
+		if (current == Buffer::END_OF_SOURCE) return this->token = Token(this->buffer.offset(this->buffer.pending_end()), TokenType::END_OF_FILE);
 
+		if (!is_ascii(current) && !this->cursor.accepts(current)) {
+			std::size_t pending_size = this->cursor.get_steps_since_last_final_state();
 
+			if (this->in_comment()) {
+				if (pending_size == 0) {
+					this->lexem_size++;
+					return this->skip_invalid_comment_bytes(1);
+				}
 
-	static State start({
-		&to_identifier_final_by_alpha,
-		&to_integer_final_by_numeric,
-		&to_plus_final_by_plus,
-		&to_minus_final_by_minus,
-		&to_colon_final_by_colon,
-		&to_asterisk_final_by_asterisk,
-		&to_less_than_final_by_less_than,
-		&to_greater_than_final_by_greater_than,
-		&to_equality_final_by_equal,
-		&to_logical_not_final_by_exclamation_mark,
-		&to_semicolon_final_by_semicolon,
-		&to_parenthesis_open_final_by_parenthesis_open,
-		&to_parenthesis_close_final_by_parenthesis_close,
-		&to_curly_bracket_open_final_by_curly_bracket_open,
-		&to_curly_bracket_close_final_by_curly_bracket_close,
-		&to_square_bracket_open_final_by_square_bracket_open,
-		&to_square_bracket_close_final_by_square_bracket_close,
-		&to_logical_and_non_final_by_and,
-		&to_mac_line_feed_final_by_carriage_return,
-		&to_unix_line_feed_final_by_new_line
-	});
+				this->buffer.unget();
+				return this->skip_invalid_comment_bytes(pending_size);
+			}
 
-	return FiniteStateMachine(&start);
-}
+			this->token = Token(this->buffer.offset(this->buffer.pending_begin() - 1), static_cast<char>(current), TokenType::UNSUPPORTED_CHARACTER);
+			if (this->lexem_size != 0) this->interrupt_lexem(1);
+			return this->token;
+		}
 
-Scanner::Scanner(const String& file)
-	: file_position()
-	, line_count_callback(std::bind(&FilePosition::on_state_change, &this->file_position, std::placeholders::_1, std::placeholders::_2))
-	, finite_state_machine(init_finite_state_machine(this->line_count_callback)), symboltable(), buffer(file), lexem(), token() {
+		this->lexem_size++;
 
-	this->init_symboltable();
-}
+		if (this->cursor.process(current)) this->skip_loop();
+		else {
+			Token* token = nullptr;
+			std::size_t steps_since_last_final_state = this->cursor.get_steps_since_last_final_state();
 
-/*
- * Initializes the Symboltable with some keywords.
- */
-void Scanner::init_symboltable() {
-	this->symboltable.insert("while", TokenType::WHILE);
-	this->symboltable.insert("WHILE", TokenType::WHILE);
-	this->symboltable.insert("if", TokenType::IF);
-	this->symboltable.insert("IF", TokenType::IF);
-	this->symboltable.insert("else", TokenType::ELSE);
-	this->symboltable.insert("ELSE", TokenType::ELSE);
-	this->symboltable.insert("read", TokenType::READ);
-	this->symboltable.insert("write", TokenType::WRITE);
-	this->symboltable.insert("int", TokenType::INT);
-}
+			if (this->in_utf8_sequence(steps_since_last_final_state - 1)) {
+				this->buffer.unget();
+				this->lexem_size--;
+				return this->skip_invalid_comment_bytes(steps_since_last_final_state - 1);
+			}
 
-Token* Scanner::make_integer_token(const String& lexem) {
-	errno = 0;
-	long integer = strtol(lexem.c_str(), nullptr, 10);
+			bool interrupted = this->interrupted_lexem.size() != 0;
 
-	if (errno == ERANGE) {
-		Information* information = this->symboltable.insert(lexem, TokenType::OUT_OF_RANGE_INTEGER);
-		return &(this->token = Token(this->file_position.get_line(), this->file_position.get_column(), TokenType::OUT_OF_RANGE_INTEGER, information));
-	}
+			if (steps_since_last_final_state == this->lexem_size) {
+				char first = interrupted ? this->interrupted_lexem[0] : *this->buffer.marked();
 
-	return &(this->token = Token(this->file_position.get_line(), this->file_position.get_column(), integer));
-}
+				if (!is_space(first)) {
+					token = &(this->token = Token(this->lexem_offset, first));
+					for (std::size_t steps_back = steps_since_last_final_state; steps_back > 1; steps_back--) this->buffer.unget();
+				}
+			}
+			else {
+				for (std::size_t steps_back = steps_since_last_final_state; steps_back > 0; steps_back--) this->buffer.unget();
+
+				std::size_t lexem_size = this->lexem_size - steps_since_last_final_state;
+				std::size_t interrupted_size = this->interrupted_lexem.size();
+				if (interrupted) {
+					if (lexem_size > interrupted_size) this->interrupted_lexem.append(this->buffer.marked(), this->buffer.marked() + (lexem_size - interrupted_size));
+					else this->interrupted_lexem = String(this->interrupted_lexem, lexem_size);
+				}
+
+				Lexeme lexem = interrupted ? Lexeme(this->interrupted_lexem) : Lexeme(this->buffer.marked(), lexem_size);
+				TokenType token_type = this->cursor.get_last_final_token();
+
+				switch(token_type) {
+				case TokenType::LINE_FEED:
+				case TokenType::COMMENT:
+					break;
+				case TokenType::INTEGER: {
+					token = this->make_integer_token(lexem);
+					break; }
+				case TokenType::IDENTIFIER: {
+					token = this->make_identifier_token(lexem);
+					break; }
+				default: {
+					token = &(this->token = Token(this->lexem_offset, token_type)); }
+				}
+			}
 
-Token Scanner::next_token() {
+			this->lexem_size = 0;
+			if (interrupted) this->interrupted_lexem.clear();
+			this->cursor.reset();
 
-	while (true) {
-		char current = this->buffer.get();
-		this->lexem += current;
-
-		try {
-			if (!this->finite_state_machine.process(current)) {
-				Token* token = nullptr;
-		                std::size_t steps_since_last_final_state = this->finite_state_machine.get_steps_since_last_final_state();
-
-        		        if (steps_since_last_final_state == this->lexem.size()) {
-        		            if (!is_space(this->lexem[0])) {
-        		                token = &(this->token = Token(this->file_position.get_line(), this->file_position.get_column(), this->lexem[0]));
-        		                for (std::size_t steps_back = steps_since_last_final_state; steps_back > 1; steps_back--) this->buffer.unget();
-        		            }
-        		            this->file_position.increment_column();
-        		        }
-        		        else {
-        		            for (std::size_t steps_back = steps_since_last_final_state; steps_back > 0; steps_back--) this->buffer.unget();
-
-        		            TokenType token_type = this->finite_state_machine.get_last_final_state().token();
-
-        		            if (token_type != TokenType::LINE_FEED) {
-        		                String actual_lexem(this->lexem.begin(), this->lexem.end() - steps_since_last_final_state);
-
-        		                switch(token_type) {
-        		                case TokenType::COMMENT: {
-        		                    long last_line_length = std::distance(actual_lexem.find_last_of("\r\n"), actual_lexem.cend()) - 1;
-        		                    this->file_position.increment_column(last_line_length == -1 ? actual_lexem.size() : last_line_length);
-        		                    break; }
-        		                case TokenType::INTEGER: {
-        		                    token = this->make_integer_token(actual_lexem);
-        		                    this->file_position.increment_column(actual_lexem.size());
-        		                    break; }
-        		                case TokenType::IDENTIFIER: {
-        		                    Information* information = this->symboltable.insert(actual_lexem);
-        		                    token = &(this->token = Token(this->file_position.get_line(), this->file_position.get_column(), information->token_type, information));
-        		                    this->file_position.increment_column(actual_lexem.size());
-        		                    break; }
-        		                default: {
-        		                    token = &(this->token = Token(this->file_position.get_line(), this->file_position.get_column(), token_type));
-        		                    this->file_position.increment_column(actual_lexem.size()); }
-        		                }
-
-        		            }
-        		        }
-
-        	        	this->lexem.clear();
-	        	        this->finite_state_machine.reset();
-
-        		        if (token) {
-	        	            return *token;
-	        	        }
+			if (token) {
+				return *token;
 			}
-		} catch(const UnsupportedCharacterEncodingException& encoding_exception) {
-		    this->file_position.increment_column(1);
-		    this->lexem = String(this->lexem.cbegin(), this->lexem.cend() - 1);
-		    throw;
 		}
 	}
 
-	throw TokenGeneratingException("Scanner::next_token()");
+	throw TokenGeneratingException("Scanner::scan_token()");
 }
@@ -0,0 +1,427 @@
+#include "finite_state_machine.h"
+#include "character_classification.h"
+#include "scanner_graph.h"
+
+/*
+ * The States and Transitions are function-local statics wired together by add(), so this must run exactly once, see scanner_graph().
+ */
+static const State* init_scanner_graph() {
+
+	// Identifier States and Transitions
+	static FinalState identifier_final(TokenType::IDENTIFIER);
+
+	static TypeTransition to_identifier_final_by_alpha_numeric(&identifier_final, CharClass::ALPHA_NUMERIC);
+	identifier_final.add(&to_identifier_final_by_alpha_numeric);
+
+	static TypeTransition to_identifier_final_by_alpha(&identifier_final, CharClass::ALPHA);
+	identifier_final.add(&to_identifier_final_by_alpha);
+
+	// Keyword States and Transitions (Depends upon Identifier States and Transitions)
+	// Every keyword is a path of FinalStates, which are identifiers unless the keyword is complete. Their alpha numeric transitions to the
+	// identifier come first, so the keyword transitions added behind them take precedence in the branch matrix.
+	static FinalState keyword_while_final(TokenType::WHILE, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_while_final_by_e(&keyword_while_final, 'e');
+
+	static FinalState keyword_whil_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_whil_final.add(&to_keyword_while_final_by_e);
+
+	static CharTransition to_keyword_whil_final_by_l(&keyword_whil_final, 'l');
+
+	static FinalState keyword_whi_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_whi_final.add(&to_keyword_whil_final_by_l);
+
+	static CharTransition to_keyword_whi_final_by_i(&keyword_whi_final, 'i');
+
+	static FinalState keyword_wh_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_wh_final.add(&to_keyword_whi_final_by_i);
+
+	static CharTransition to_keyword_wh_final_by_h(&keyword_wh_final, 'h');
+
+	static FinalState keyword_write_final(TokenType::WRITE, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_write_final_by_e(&keyword_write_final, 'e');
+
+	static FinalState keyword_writ_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_writ_final.add(&to_keyword_write_final_by_e);
+
+	static CharTransition to_keyword_writ_final_by_t(&keyword_writ_final, 't');
+
+	static FinalState keyword_wri_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_wri_final.add(&to_keyword_writ_final_by_t);
+
+	static CharTransition to_keyword_wri_final_by_i(&keyword_wri_final, 'i');
+
+	static FinalState keyword_wr_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_wr_final.add(&to_keyword_wri_final_by_i);
+
+	static CharTransition to_keyword_wr_final_by_r(&keyword_wr_final, 'r');
+
+	static FinalState keyword_w_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_w_final.add(&to_keyword_wh_final_by_h);
+	keyword_w_final.add(&to_keyword_wr_final_by_r);
+
+	static CharTransition to_keyword_w_final_by_w(&keyword_w_final, 'w');
+
+
+	static FinalState keyword_WHILE_final(TokenType::WHILE, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_WHILE_final_by_E(&keyword_WHILE_final, 'E');
+
+	static FinalState keyword_WHIL_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_WHIL_final.add(&to_keyword_WHILE_final_by_E);
+
+	static CharTransition to_keyword_WHIL_final_by_L(&keyword_WHIL_final, 'L');
+
+	static FinalState keyword_WHI_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_WHI_final.add(&to_keyword_WHIL_final_by_L);
+
+	static CharTransition to_keyword_WHI_final_by_I(&keyword_WHI_final, 'I');
+
+	static FinalState keyword_WH_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_WH_final.add(&to_keyword_WHI_final_by_I);
+
+	static CharTransition to_keyword_WH_final_by_H(&keyword_WH_final, 'H');
+
+	static FinalState keyword_W_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_W_final.add(&to_keyword_WH_final_by_H);
+
+	static CharTransition to_keyword_W_final_by_W(&keyword_W_final, 'W');
+
+
+	static FinalState keyword_if_final(TokenType::IF, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_if_final_by_f(&keyword_if_final, 'f');
+
+	static FinalState keyword_int_final(TokenType::INT, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_int_final_by_t(&keyword_int_final, 't');
+
+	static FinalState keyword_in_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_in_final.add(&to_keyword_int_final_by_t);
+
+	static CharTransition to_keyword_in_final_by_n(&keyword_in_final, 'n');
+
+	static FinalState keyword_i_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_i_final.add(&to_keyword_if_final_by_f);
+	keyword_i_final.add(&to_keyword_in_final_by_n);
+
+	static CharTransition to_keyword_i_final_by_i(&keyword_i_final, 'i');
+
+
+	static FinalState keyword_IF_final(TokenType::IF, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_IF_final_by_F(&keyword_IF_final, 'F');
+
+	static FinalState keyword_I_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_I_final.add(&to_keyword_IF_final_by_F);
+
+	static CharTransition to_keyword_I_final_by_I(&keyword_I_final, 'I');
+
+
+	static FinalState keyword_else_final(TokenType::ELSE, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_else_final_by_e(&keyword_else_final, 'e');
+
+	static FinalState keyword_els_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_els_final.add(&to_keyword_else_final_by_e);
+
+	static CharTransition to_keyword_els_final_by_s(&keyword_els_final, 's');
+
+	static FinalState keyword_el_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_el_final.add(&to_keyword_els_final_by_s);
+
+	static CharTransition to_keyword_el_final_by_l(&keyword_el_final, 'l');
+
+	static FinalState keyword_e_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_e_final.add(&to_keyword_el_final_by_l);
+
+	static CharTransition to_keyword_e_final_by_e(&keyword_e_final, 'e');
+
+
+	static FinalState keyword_ELSE_final(TokenType::ELSE, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_ELSE_final_by_E(&keyword_ELSE_final, 'E');
+
+	static FinalState keyword_ELS_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_ELS_final.add(&to_keyword_ELSE_final_by_E);
+
+	static CharTransition to_keyword_ELS_final_by_S(&keyword_ELS_final, 'S');
+
+	static FinalState keyword_EL_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_EL_final.add(&to_keyword_ELS_final_by_S);
+
+	static CharTransition to_keyword_EL_final_by_L(&keyword_EL_final, 'L');
+
+	static FinalState keyword_E_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_E_final.add(&to_keyword_EL_final_by_L);
+
+	static CharTransition to_keyword_E_final_by_E(&keyword_E_final, 'E');
+
+
+	static FinalState keyword_read_final(TokenType::READ, &to_identifier_final_by_alpha_numeric);
+
+	static CharTransition to_keyword_read_final_by_d(&keyword_read_final, 'd');
+
+	static FinalState keyword_rea_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_rea_final.add(&to_keyword_read_final_by_d);
+
+	static CharTransition to_keyword_rea_final_by_a(&keyword_rea_final, 'a');
+
+	static FinalState keyword_re_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_re_final.add(&to_keyword_rea_final_by_a);
+
+	static CharTransition to_keyword_re_final_by_e(&keyword_re_final, 'e');
+
+	static FinalState keyword_r_final(TokenType::IDENTIFIER, &to_identifier_final_by_alpha_numeric);
+	keyword_r_final.add(&to_keyword_re_final_by_e);
+
+	static CharTransition to_keyword_r_final_by_r(&keyword_r_final, 'r');
+
+	// Number States and Transitions
+	static FinalState integer_final(TokenType::INTEGER);
+
+	static TypeTransition to_integer_final_by_numeric(&integer_final, CharClass::NUMERIC);
+	integer_final.add(&to_integer_final_by_numeric);
+
+	// Plus States and Transitions
+	static FinalState plus_final(TokenType::PLUS);
+
+	static CharTransition to_plus_final_by_plus(&plus_final, '+');
+
+	// Minus States and Transitions
+	static FinalState minus_final(TokenType::MINUS);
+
+	static CharTransition to_minus_final_by_minus(&minus_final, '-');
+
+	// Comment States and Transitions (Depends upon Colon States and Transitions and serves as dependency for Linefeed States and Transitions within Comments)
+	static FinalState comment_entry(TokenType::COMMENT);
+
+	static TypeTransition to_comment_entry_by_any(&comment_entry, CharClass::ANY);
+	comment_entry.add(&to_comment_entry_by_any);
+
+	static CharTransition to_comment_entry_by_asterisk(&comment_entry, '*');
+
+
+	static FinalState comment_exit(TokenType::COMMENT, &to_comment_entry_by_any);
+
+	static CharTransition to_comment_exit_by_asterisk(&comment_exit, '*');
+	comment_entry.add(&to_comment_exit_by_asterisk);
+
+
+	static FinalState comment_final(TokenType::COMMENT);
+
+	static CharTransition to_comment_final_by_colon(&comment_final, ':');
+	comment_exit.add(&to_comment_final_by_colon);
+
+	// Linefeed States and Transitions within Comments (Depens upon Comment States and Transitions and serves as dependency for Comment States and Transitions)
+
+	static FinalState comment_mac_line_feed_final(TokenType::COMMENT, &to_comment_entry_by_any);
+
+	comment_mac_line_feed_final.add(&to_comment_exit_by_asterisk);
+
+	static CharTransition to_comment_mac_line_feed_final_by_carriage_return(&comment_mac_line_feed_final, '\r');
+	comment_mac_line_feed_final.add(&to_comment_mac_line_feed_final_by_carriage_return);
+	comment_entry.add(&to_comment_mac_line_feed_final_by_carriage_return);
+	comment_exit.add(&to_comment_mac_line_feed_final_by_carriage_return);
+
+
+	static FinalState comment_unix_line_feed_final(TokenType::COMMENT, &to_comment_entry_by_any);
+
+	static CharTransition to_comment_unix_line_feed_final_by_line_feed(&comment_mac_line_feed_final, '\n');
+	comment_mac_line_feed_final.add(&to_comment_unix_line_feed_final_by_line_feed);
+	comment_entry.add(&to_comment_unix_line_feed_final_by_line_feed);
+	comment_exit.add(&to_comment_unix_line_feed_final_by_line_feed);
+	comment_unix_line_feed_final.add(&to_comment_unix_line_feed_final_by_line_feed);
+
+	comment_unix_line_feed_final.add(&to_comment_exit_by_asterisk);
+	comment_unix_line_feed_final.add(&to_comment_mac_line_feed_final_by_carriage_return);
+
+	// UTF-8 States and Transitions within Comments (Depends upon Comment States and Transitions and Linefeed States and Transitions within Comments)
+	// Comments may contain well-formed UTF-8, see table 3-7 of the Unicode Standard. The lead byte determines the number of continuation
+	// bytes and, for E0, ED, F0 and F4, narrows the range of the first one, which rules out overlong encodings, surrogates and code points
+	// above U+10FFFF. The States within a sequence aren't final, so a malformed sequence crashes the machine before it is complete.
+	static RangeTransition to_comment_entry_by_continuation(&comment_entry, 0x80, 0xBF);
+	static State comment_utf8_tail_1(&to_comment_entry_by_continuation);
+
+	static RangeTransition to_comment_utf8_tail_1_by_continuation(&comment_utf8_tail_1, 0x80, 0xBF);
+	static State comment_utf8_tail_2(&to_comment_utf8_tail_1_by_continuation);
+
+	static RangeTransition to_comment_utf8_tail_2_by_continuation(&comment_utf8_tail_2, 0x80, 0xBF);
+	static State comment_utf8_tail_3(&to_comment_utf8_tail_2_by_continuation);
+
+	static RangeTransition to_comment_utf8_tail_1_by_e0_continuation(&comment_utf8_tail_1, 0xA0, 0xBF);
+	static State comment_utf8_e0(&to_comment_utf8_tail_1_by_e0_continuation);
+
+	static RangeTransition to_comment_utf8_tail_1_by_ed_continuation(&comment_utf8_tail_1, 0x80, 0x9F);
+	static State comment_utf8_ed(&to_comment_utf8_tail_1_by_ed_continuation);
+
+	static RangeTransition to_comment_utf8_tail_2_by_f0_continuation(&comment_utf8_tail_2, 0x90, 0xBF);
+	static State comment_utf8_f0(&to_comment_utf8_tail_2_by_f0_continuation);
+
+	static RangeTransition to_comment_utf8_tail_2_by_f4_continuation(&comment_utf8_tail_2, 0x80, 0x8F);
+	static State comment_utf8_f4(&to_comment_utf8_tail_2_by_f4_continuation);
+
+	static RangeTransition to_comment_utf8_tail_1_by_two_byte_lead(&comment_utf8_tail_1, 0xC2, 0xDF);
+	static CharTransition to_comment_utf8_e0_by_e0(&comment_utf8_e0, '\xE0');
+	static RangeTransition to_comment_utf8_tail_2_by_three_byte_lead(&comment_utf8_tail_2, 0xE1, 0xEC);
+	static CharTransition to_comment_utf8_ed_by_ed(&comment_utf8_ed, '\xED');
+	static RangeTransition to_comment_utf8_tail_2_by_upper_three_byte_lead(&comment_utf8_tail_2, 0xEE, 0xEF);
+	static CharTransition to_comment_utf8_f0_by_f0(&comment_utf8_f0, '\xF0');
+	static RangeTransition to_comment_utf8_tail_3_by_four_byte_lead(&comment_utf8_tail_3, 0xF1, 0xF3);
+	static CharTransition to_comment_utf8_f4_by_f4(&comment_utf8_f4, '\xF4');
+
+	static const Vector<const Transition*> to_comment_utf8_by_lead({
+		&to_comment_utf8_tail_1_by_two_byte_lead,
+		&to_comment_utf8_e0_by_e0,
+		&to_comment_utf8_tail_2_by_three_byte_lead,
+		&to_comment_utf8_ed_by_ed,
+		&to_comment_utf8_tail_2_by_upper_three_byte_lead,
+		&to_comment_utf8_f0_by_f0,
+		&to_comment_utf8_tail_3_by_four_byte_lead,
+		&to_comment_utf8_f4_by_f4
+	});
+
+	comment_entry.add(to_comment_utf8_by_lead);
+	comment_exit.add(to_comment_utf8_by_lead);
+	comment_mac_line_feed_final.add(to_comment_utf8_by_lead);
+	comment_unix_line_feed_final.add(to_comment_utf8_by_lead);
+
+	// Assignment States and Transitions (Depends upon Colon States and Transitions)
+	static FinalState assignment_final(TokenType::ASSIGNMENT);
+
+	static CharTransition to_assignment_final_by_equal(&assignment_final, '=');
+
+	// Colon States and Transitions (Serves as dependency for Assignment and Comment States and Transitions)
+	static FinalState colon_final(TokenType::COLON, {&to_assignment_final_by_equal, &to_comment_entry_by_asterisk});
+
+	static CharTransition to_colon_final_by_colon(&colon_final, ':');
+
+	// Asterisk States and Transitions
+	static FinalState asterisk_final(TokenType::ASTERISK);
+
+	static CharTransition to_asterisk_final_by_asterisk(&asterisk_final, '*');
+
+	// Less Than States and Transitions
+	static FinalState less_than_final(TokenType::LESS_THAN);
+
+	static CharTransition to_less_than_final_by_less_than(&less_than_final, '<');
+
+	// Greater Than States and Transitions
+	static FinalState greater_than_final(TokenType::GREATER_THAN);
+
+	static CharTransition to_greater_than_final_by_greater_than(&greater_than_final, '>');
+
+	// Whatever States and Transitions (Depends upon Equality States and Transitions)
+	static FinalState whatever_final(TokenType::WHATEVER);
+
+	static CharTransition to_whatever_final_by_equal(&whatever_final, '=');
+	static State whatever_non_final(&to_whatever_final_by_equal);
+
+	static CharTransition to_whatever_non_final_by_colon(&whatever_non_final, ':');
+
+	// Equality States and Transitions (Serves as dependency for Whatever States and Transitions)
+	static FinalState equality_final(TokenType::EQUALITY, &to_whatever_non_final_by_colon);
+
+	static CharTransition to_equality_final_by_equal(&equality_final, '=');
+
+	// Logical Not States and Transitions
+	static FinalState logical_not_final(TokenType::NOT);
+
+	static CharTransition to_logical_not_final_by_exclamation_mark(&logical_not_final, '!');
+
+	// Semicolon States and Transitions
+	static FinalState semicolon_final(TokenType::SEMICOLON);
+
+	static CharTransition to_semicolon_final_by_semicolon(&semicolon_final, ';');
+
+	// Parenthesis Open States and Transitions
+	static FinalState parenthesis_open_final(TokenType::PARENTHESIS_OPEN);
+
+	static CharTransition to_parenthesis_open_final_by_parenthesis_open(&parenthesis_open_final, '(');
+
+	// Parenthesis Close States and Transitions
+	static FinalState parenthesis_close_final(TokenType::PARENTHESIS_CLOSE);
+
+	static CharTransition to_parenthesis_close_final_by_parenthesis_close(&parenthesis_close_final, ')');
+
+	// Curly Bracket Open States and Transitions
+	static FinalState curly_bracket_open_final(TokenType::CURLY_BRACKET_OPEN);
+
+	static CharTransition to_curly_bracket_open_final_by_curly_bracket_open(&curly_bracket_open_final, '{');
+
+	// Curly Bracket Close States and Transitions
+	static FinalState curly_bracket_close_final(TokenType::CURLY_BRACKET_CLOSE);
+
+	static CharTransition to_curly_bracket_close_final_by_curly_bracket_close(&curly_bracket_close_final, '}');
+
+	// Square Bracket Open States and Transitions
+	static FinalState square_bracket_open_final(TokenType::SQUARE_BRACKET_OPEN);
+
+	static CharTransition to_square_bracket_open_final_by_square_bracket_open(&square_bracket_open_final, '[');
+
+	// Square Bracket Close States and Transitions
+	static FinalState square_bracket_close_final(TokenType::SQUARE_BRACKET_CLOSE);
+
+	static CharTransition to_square_bracket_close_final_by_square_bracket_close(&square_bracket_close_final, ']');
+
+	// Logical And States and Transitions
+	static FinalState logical_and_final(TokenType::LOGICAL_AND);
+
+	static CharTransition to_logical_and_final_by_and(&logical_and_final, '&');
+	static State logical_and_non_final(&to_logical_and_final_by_and);
+
+	static CharTransition to_logical_and_non_final_by_and(&logical_and_non_final, '&');
+
+	// Linefeed States and Transitions
+	static FinalState mac_line_feed_final(TokenType::LINE_FEED);
+
+	static CharTransition to_mac_line_feed_final_by_carriage_return(&mac_line_feed_final, '\r');
+	mac_line_feed_final.add(&to_mac_line_feed_final_by_carriage_return);
+
+
+	static FinalState unix_line_feed_final(TokenType::LINE_FEED, &to_mac_line_feed_final_by_carriage_return);
+
+	static CharTransition to_unix_line_feed_final_by_new_line(&unix_line_feed_final, '\n');
+	unix_line_feed_final.add(&to_unix_line_feed_final_by_new_line);
+	mac_line_feed_final.add(&to_unix_line_feed_final_by_new_line);
+
+
+
+	static State start({
+		&to_identifier_final_by_alpha,
+		&to_keyword_w_final_by_w,
+		&to_keyword_W_final_by_W,
+		&to_keyword_i_final_by_i,
+		&to_keyword_I_final_by_I,
+		&to_keyword_e_final_by_e,
+		&to_keyword_E_final_by_E,
+		&to_keyword_r_final_by_r,
+		&to_integer_final_by_numeric,
+		&to_plus_final_by_plus,
+		&to_minus_final_by_minus,
+		&to_colon_final_by_colon,
+		&to_asterisk_final_by_asterisk,
+		&to_less_than_final_by_less_than,
+		&to_greater_than_final_by_greater_than,
+		&to_equality_final_by_equal,
+		&to_logical_not_final_by_exclamation_mark,
+		&to_semicolon_final_by_semicolon,
+		&to_parenthesis_open_final_by_parenthesis_open,
+		&to_parenthesis_close_final_by_parenthesis_close,
+		&to_curly_bracket_open_final_by_curly_bracket_open,
+		&to_curly_bracket_close_final_by_curly_bracket_close,
+		&to_square_bracket_open_final_by_square_bracket_open,
+		&to_square_bracket_close_final_by_square_bracket_close,
+		&to_logical_and_non_final_by_and,
+		&to_mac_line_feed_final_by_carriage_return,
+		&to_unix_line_feed_final_by_new_line
+	});
+
+	return &start;
+}
+
+const State* scanner_graph() {
+	static const State* start = init_scanner_graph();
+	return start;
+}
@@ -0,0 +1,65 @@
+#include "skip_kernels.h"
+#include "vector_skip_kernels.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+struct Sse2 {
+	typedef __m128i vector;
+
+	const static std::size_t WIDTH = 16;
+	const static unsigned int FULL_MASK = 0xFFFFu;
+
+	static vector load(const char* source) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)); }
+	static vector set(char symbol) { return _mm_set1_epi8(symbol); }
+	static vector equal(vector left, vector right) { return _mm_cmpeq_epi8(left, right); }
+	static vector either(vector left, vector right) { return _mm_or_si128(left, right); }
+	static unsigned int mask(vector symbols) { return static_cast<unsigned int>(_mm_movemask_epi8(symbols)); }
+
+	static vector in_range(vector symbols, char low, char high) {
+		vector bound = Sse2::set(static_cast<char>(high - low));
+		return _mm_cmpeq_epi8(_mm_max_epu8(_mm_sub_epi8(symbols, Sse2::set(low)), bound), bound);
+	}
+};
+#else
+static const char* skip_run_scalar(SkipKernel kernel, const char* begin, const char* end) {
+	while (begin != end && skip_kernel_matches(kernel, static_cast<unsigned char>(*begin))) begin++;
+	return begin;
+}
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+const char* skip_run_avx2(SkipKernel kernel, const char* begin, const char* end);
+#endif
+
+/*
+ * Picks the widest implementation the CPU supports once, so skip_run() is a single indirect call.
+ */
+static const char* (*select_skip_run())(SkipKernel, const char*, const char*) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return skip_run_avx2;
+#endif
+#ifdef __SSE2__
+	return VectorSkipKernels<Sse2>::skip;
+#else
+	return skip_run_scalar;
+#endif
+}
+
+static const char* (*const SKIP_RUN)(SkipKernel, const char*, const char*) = select_skip_run();
+
+bool skip_kernel_matches(SkipKernel kernel, unsigned char symbol) {
+	switch(kernel) {
+	case SkipKernel::BLANK: return symbol == ' ' || symbol == '\t';
+	case SkipKernel::DIGIT: return symbol >= '0' && symbol <= '9';
+	case SkipKernel::ALPHA_NUMERIC: return (symbol >= '0' && symbol <= '9') || ((symbol | 0x20) >= 'a' && (symbol | 0x20) <= 'z');
+	case SkipKernel::COMMENT_BODY: return symbol != '*' && symbol != '\r' && symbol != '\n' && symbol <= 127;
+	case SkipKernel::LINE_BODY: return symbol != '\r' && symbol != '\n';
+	default: return false;
+	}
+}
+
+const char* skip_run(SkipKernel kernel, const char* begin, const char* end) {
+	return SKIP_RUN(kernel, begin, end);
+}
@@ -0,0 +1,35 @@
+#include "vector_skip_kernels.h"
+
+/*
+ * Compiled with -mavx2 on x86, see the makefile. skip_run() only calls into here if the CPU supports AVX2.
+ */
+#ifdef __AVX2__
+#include <immintrin.h>
+
+struct Avx2 {
+	typedef __m256i vector;
+
+	const static std::size_t WIDTH = 32;
+	const static unsigned int FULL_MASK = 0xFFFFFFFFu;
+
+	static vector load(const char* source) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)); }
+	static vector set(char symbol) { return _mm256_set1_epi8(symbol); }
+	static vector equal(vector left, vector right) { return _mm256_cmpeq_epi8(left, right); }
+	static vector either(vector left, vector right) { return _mm256_or_si256(left, right); }
+	static unsigned int mask(vector symbols) { return static_cast<unsigned int>(_mm256_movemask_epi8(symbols)); }
+
+	static vector in_range(vector symbols, char low, char high) {
+		vector bound = Avx2::set(static_cast<char>(high - low));
+		return _mm256_cmpeq_epi8(_mm256_max_epu8(_mm256_sub_epi8(symbols, Avx2::set(low)), bound), bound);
+	}
+};
+
+const char* skip_run_avx2(SkipKernel kernel, const char* begin, const char* end) {
+	return VectorSkipKernels<Avx2>::skip(kernel, begin, end);
+}
+#else
+const char* skip_run_avx2(SkipKernel kernel, const char* begin, const char* end) {
+	while (begin != end && skip_kernel_matches(kernel, static_cast<unsigned char>(*begin))) begin++;
+	return begin;
+}
+#endif
@@ -1,4 +1,5 @@
 #include "string.h"
+#include <ostream>
 
 std::size_t std::strlen(const char* source) {
 	std::size_t size = 0;
@@ -6,44 +7,116 @@ std::size_t std::strlen(const char* source) {
 	return size;
 }
 
+/*
+ * Moves the bytes to the heap, if they don't fit into capacity yet.
+ */
+void String::reserve(std::size_t capacity) {
+	if (capacity <= this->get_capacity()) return;
+
+	value_type* characters = new value_type[capacity + 1];
+	__builtin_memcpy(characters, this->characters, this->length + 1);
+
+	this->release();
+	this->characters = characters;
+	this->capacity = capacity;
+}
+
+/*
+ * Frees the heap bytes, if any. Leaves the String pointing to its local bytes, but without terminating them.
+ */
+void String::release() {
+	if (!this->is_local()) delete[] this->characters;
+	this->characters = this->local;
+}
+
+/*
+ * Takes over the bytes of source, which becomes empty. This String must not own heap bytes.
+ */
+void String::take(String& source) {
+	if (source.is_local()) {
+		this->characters = this->local;
+		__builtin_memcpy(this->local, source.local, source.length + 1);
+	}
+	else {
+		this->characters = source.characters;
+		this->capacity = source.capacity;
+		source.characters = source.local;
+	}
+
+	this->length = source.length;
+	source.length = 0;
+	source.local[0] = '\0';
+}
+
 String& String::operator=(value_type source) {
-	string = Vector<value_type>(String::INITIAL_CAPACITY);
-	string.push_back(source);
-	string.push_back('\0');
-	return *this;
+	this->clear();
+	return *this += source;
 }
 
 String String::operator+(const String& source) const {
-	String tmp(this->size() + source.size() + 1);
-	tmp.string.insert(tmp.string.end() - 1, this->string.cbegin(), this->string.cend() - 1);
-	tmp.string.insert(tmp.string.end() - 1, source.string.cbegin(), source.string.cend() - 1);
+	String tmp(this->size() + source.size());
+	tmp.append(this->cbegin(), this->cend());
+	tmp.append(source.cbegin(), source.cend());
 	return tmp;
 }
 
 String String::operator+(value_type source) const {
-	String tmp(this->size() + 2);
-	tmp.string.pop_back();
-	tmp.string.insert(tmp.string.end(), this->string.cbegin(), this->string.cend() - 1);
-	tmp.string.push_back(source);
-	tmp.string.push_back('\0');
+	String tmp(this->size() + 1);
+	tmp.append(this->cbegin(), this->cend());
+	tmp += source;
 	return tmp;
 }
 
 String& String::operator+=(const String& source) {
-	if (this->string.free_capacity() >= source.size()) {
-		this->string.insert(this->string.end() - 1, source.string.cbegin(), source.string.cend() - 1);
-	}
-	else {
-		String tmp = *this + source;
-		swap(*this, tmp);
+	return this->append(source.cbegin(), source.cend());
+}
+
+String& String::operator+=(value_type source) {
+	return this->append(&source, &source + 1);
+}
+
+/*
+ * Grows the capacity at least twofold, if the bytes don't fit. The old bytes are only freed after the copy, so [begin, end) may be
+ * part of this String. An empty range may be null, it's never passed on to memcpy().
+ */
+String& String::append(const_iterator begin, const_iterator end) {
+	std::size_t count = end - begin;
+	if (count == 0) return *this;
+
+	std::size_t length = this->length + count;
+
+	if (length > this->get_capacity()) {
+		std::size_t capacity = std::max(length, this->get_capacity() * 2);
+		value_type* characters = new value_type[capacity + 1];
+
+		__builtin_memcpy(characters, this->characters, this->length);
+		__builtin_memcpy(characters + this->length, begin, count);
+
+		this->release();
+		this->characters = characters;
+		this->capacity = capacity;
 	}
+	else __builtin_memmove(this->characters + this->length, begin, count);
+
+	this->length = length;
+	this->characters[length] = '\0';
 	return *this;
 }
 
-String& String::operator+=(value_type source) {
-	this->string.pop_back();
-	this->string.push_back(source);
-	this->string.push_back('\0');
+/*
+ * Replaces the removed_size bytes at offset by [begin, end), which must not be part of this String. Only the bytes behind the removed
+ * ones are moved, and only if the size changes.
+ */
+String& String::replace(std::size_t offset, std::size_t removed_size, const_iterator begin, const_iterator end) {
+	std::size_t count = end - begin;
+	std::size_t length = this->length - removed_size + count;
+
+	if (length > this->get_capacity()) this->reserve(std::max(length, this->get_capacity() * 2));
+
+	if (count != removed_size) __builtin_memmove(this->characters + offset + count, this->characters + offset + removed_size, this->length - offset - removed_size + 1);
+	if (count != 0) __builtin_memcpy(this->characters + offset, begin, count);
+
+	this->length = length;
 	return *this;
 }
 
@@ -58,17 +131,7 @@ String::const_iterator String::find_last_of(const char* sequence) const {
 }
 
 bool operator==(const String& left, const String& right) {
-	if (left.size() != right.size()) return false;
-
-	String::const_iterator left_iterator = left.cbegin();
-	String::const_iterator right_iterator = right.cbegin();
-	String::const_iterator left_iterator_end = left.cend();
-
-	for (; left_iterator != left_iterator_end; ++left_iterator, ++right_iterator) {
-		if (*left_iterator != *right_iterator) return false;
-	}
-
-	return true;
+	return left.size() == right.size() && __builtin_memcmp(left.c_str(), right.c_str(), left.size()) == 0;
 }
 
 bool operator!=(const String& left, const String& right) {
@@ -76,8 +139,9 @@ bool operator!=(const String& left, const String& right) {
 }
 
 void swap(String& left, String& right) {
-	using std::swap;
-	swap(left.string, right.string);
+	String tmp(std::move(left));
+	left.take(right);
+	right.take(tmp);
 }
 
 std::ostream& operator<<(std::ostream& out, const String& string) {
@@ -4,7 +4,7 @@
 #include <climits>
 #include <cstdio>
 
-String Token::to_string() const {
+String Token::to_string(const Symboltable& symboltable) const {
 
     switch(this->token_type) {
 
@@ -33,18 +33,20 @@ String Token::to_string() const {
     case TokenType::WRITE: return String("write", 5);
     case TokenType::INT: return String("int", 3);
     case TokenType::LINE_FEED: return String("\n", 1);
-    case TokenType::EPSILON: return String();
+    case TokenType::EPSILON:
+    case TokenType::END_OF_FILE: return String();
     case TokenType::INTEGER: {
         const static std::size_t INTEGER_BITS = sizeof(long) * CHAR_BIT;
         const static std::size_t BITS_PER_DECIMAL_DIGIT = 3;
         const static std::size_t INTEGER_MEMORY_REQUIREMENT = (INTEGER_BITS / BITS_PER_DECIMAL_DIGIT) + 3;
         static char integer_storage[INTEGER_MEMORY_REQUIREMENT];
 
-        std::snprintf(integer_storage, INTEGER_MEMORY_REQUIREMENT, "%li", this->value.integer);
+        std::snprintf(integer_storage, INTEGER_MEMORY_REQUIREMENT, "%li", this->get_integer(symboltable));
 
         return String(integer_storage);
     }
     case TokenType::DEADBEEF:
+    case TokenType::UNSUPPORTED_CHARACTER:
 	const static std::size_t BITS_PER_DECIMAL_DIGIT = 3;
 	const static std::size_t CHAR_MEMORY_REQUIREMENT = (CHAR_BIT / BITS_PER_DECIMAL_DIGIT) + 3;
 	static char char_storage[CHAR_MEMORY_REQUIREMENT];
@@ -55,8 +57,8 @@ String Token::to_string() const {
     case TokenType::IDENTIFIER:
     case TokenType::OUT_OF_RANGE_INTEGER:
     case TokenType::COMMENT:
-        return *(this->value.information->lexem);
-    default: throw UnsupportedTokenTypeException("Token::to_string() const", this->token_type);
+        return this->get_lexem(symboltable);
+    default: throw UnsupportedTokenTypeException("Token::to_string(const Symboltable&) const", this->token_type);
     }
 }
 
@@ -93,29 +95,31 @@ std::ostream& operator<<(std::ostream& out, TokenType token_type) {
 	case TokenType::INT: return out.write("INT", 3);
 	case TokenType::COMMENT: return out.write("COMMENT", 7);
 	case TokenType::LINE_FEED: return out.write("LINE_FEED", 9);
+	case TokenType::UNSUPPORTED_CHARACTER: return out.write("UNSUPPORTED_CHARACTER", 21);
+	case TokenType::END_OF_FILE: return out.write("END_OF_FILE", 11);
 	case TokenType::EPSILON: return out.write("EPSILON", 7);
 	default: throw UnsupportedTokenTypeException("operator<<(std::ostream& out, TokenType token_type)", token_type);
 	}
 }
 
-std::ostream& operator<<(std::ostream& out, const Token& token) {
-	out << token.line << ':' << token.column;
-	out.write(": ", 2);
+std::ostream& operator<<(std::ostream& out, const DescribedToken& described_token) {
+	const Token& token = described_token.token;
 	out << token.token_type;
 
 	switch(token.token_type) {
 	case TokenType::INTEGER:
-		out << ' ' << token.value.integer;
+		out << ' ' << token.get_integer(described_token.symboltable);
 		break;
 	case TokenType::DEADBEEF:
+	case TokenType::UNSUPPORTED_CHARACTER:
 		out << " '" << static_cast<unsigned int>(static_cast<unsigned char>(token.value.error_char)) << '\'';
 		break;
 	case TokenType::IDENTIFIER:
 	case TokenType::OUT_OF_RANGE_INTEGER: {
 		out << ' ';
 
-		const Information& information = *token.value.information;
-		out.write((information.lexem)->c_str(), (information.lexem)->size());
+		const String& lexem = token.get_lexem(described_token.symboltable);
+		out.write(lexem.c_str(), lexem.size());
 		break;
     }
 	default: { /* pass - don't handle other TokenTypes in a special way */ }
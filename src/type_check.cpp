@@ -5,7 +5,7 @@
 FundamentalType TypeCheck::get_data_type(const node_type& node) const {
     const Parser::TreeData& userdata = node.userdata();
 
-    if(userdata.is_token()) return userdata.token().get_data_type();
+    if(userdata.is_token()) return userdata.token().get_data_type(*this->symboltable);
     return node.get_data_type();
 }
 
@@ -13,7 +13,7 @@ FundamentalType TypeCheck::get_data_type(const node_type& node) const {
 void TypeCheck::set_data_type(node_type* node, FundamentalType data_type) const {
     Parser::TreeData& userdata = node->userdata();
 
-    if(userdata.is_token()) userdata.token().set_data_type(data_type);
+    if(userdata.is_token()) userdata.token().set_data_type(*this->symboltable, data_type);
     else node->set_data_type(data_type);
 }
 
@@ -64,7 +64,7 @@ void TypeCheck::handle_error(node_type* source_node, const char* message, const
     this->valid = false;
 
     if(affected_node.has_userdata()) {
-        if(affected_node.userdata().is_token()) *this->error_stream << this->get_token(affected_node);
+        if(affected_node.userdata().is_token()) *this->error_stream << this->line_index->locate(this->get_token(affected_node), *this->symboltable);
         else *this->error_stream << (affected_node.userdata().variable());
     }
     else *this->error_stream << this->get_data_type(affected_node);
@@ -72,7 +72,7 @@ void TypeCheck::handle_error(node_type* source_node, const char* message, const
     *this->error_stream << " - " << message << "\nWithin this context: ";
 
     Vector<const Token*> token(this->collect_neighbours(affected_node, hierarchy_levels));
-    *this->error_stream << token[0]->line << ':' << token[0]->column << ": " << this->reconstruct_source(token);
+    *this->error_stream << this->line_index->resolve(token[0]->offset) << ": " << this->reconstruct_source(token);
 
     this->handle_error_sub_message(sub_message_type, affected_node);
 }
@@ -86,7 +86,7 @@ void TypeCheck::handle_error_sub_message(TypeCheck::ErrorSubMessage sub_message_
         const node_type& first_definition_node = this->identifier_dictionary_get(node);
         Vector<const Token*> token(this->collect_neighbours(node));
 
-        *this->error_stream << "\nFirst defined here " << this->get_token(first_definition_node) << " - " << this->reconstruct_source(token);
+        *this->error_stream << "\nFirst defined here " << this->line_index->locate(this->get_token(first_definition_node), *this->symboltable) << " - " << this->reconstruct_source(token);
         break;
     }
     case TypeCheck::ErrorSubMessage::INCOMPATIBLE_TYPES_IN_ASSIGNMENT: {
@@ -115,18 +115,17 @@ String TypeCheck::reconstruct_source(const Vector<const Token*>& token) const {
     if(token.size() == 0) return String();
 
     String output;
-    std::size_t last_token_line = token[0]->line, next_token_earliest_column = token[0]->column;
+    std::uint32_t next_token_earliest_offset = token[0]->offset;
 
     for(Vector<const Token*>::const_iterator token_iterator = token.cbegin(), token_end_iterator = token.cend(); token_iterator != token_end_iterator; ++token_iterator) {
 
         const Token* token = (*token_iterator);
 
-        if(token->line != last_token_line || token->column > next_token_earliest_column) output += ' ';
-        String token_string(token->to_string());
+        if(token->offset > next_token_earliest_offset) output += ' ';
+        String token_string(token->to_string(*this->symboltable));
         output += token_string;
 
-        last_token_line = token->line;
-        next_token_earliest_column = token->column + token_string.size();
+        next_token_earliest_offset = token->offset + token_string.size();
     }
 
     return output;
@@ -146,13 +145,13 @@ FundamentalType TypeCheck::determine_identifier_compound_type(const node_type& n
 
 
 void TypeCheck::identifier_dictionary_add(const node_type& node) {
-    const String* lexem = this->get_token(node).value.information->lexem;
+    const String* lexem = &this->get_token(node).get_lexem(*this->symboltable);
     this->identifier_dictionary.insert(lexem, &node);
 }
 
 
 const TypeCheck::node_type& TypeCheck::identifier_dictionary_get(const node_type& node) const {
-    const String* lexem = this->get_token(node).value.information->lexem;
+    const String* lexem = &this->get_token(node).get_lexem(*this->symboltable);
     return *(*this->identifier_dictionary.find(lexem)).second;
 }
 
@@ -196,7 +195,7 @@ void TypeCheck::check_decl(node_type* decl) {
 
 void TypeCheck::check_array(node_type* array) {
     if(array->child_count()) {
-        if(this->get_token(array->child(1)).value.integer > 0) this->set_data_type(array, FundamentalType::ARRAY);
+        if(this->get_token(array->child(1)).get_integer(*this->symboltable) > 0) this->set_data_type(array, FundamentalType::ARRAY);
         else {
             this->handle_error(array, "No valid dimension", array->child(1), TypeCheck::ErrorSubMessage::NONE, 2);
         }
@@ -374,7 +373,8 @@ void TypeCheck::check_op_exp(node_type* op_exp) {
 void TypeCheck::check_op(node_type* op) {}
 
 
-TypeCheck::TypeCheck(ParseTree<Parser::TreeData>* parse_tree, std::ostream* error_stream) : parse_tree(parse_tree), error_stream(error_stream), valid(true) {}
+TypeCheck::TypeCheck(ParseTree<Parser::TreeData>* parse_tree, std::ostream* error_stream, LineIndex* line_index, const Symboltable* symboltable)
+    : parse_tree(parse_tree), error_stream(error_stream), line_index(line_index), symboltable(symboltable), valid(true) {}
 
 
 bool TypeCheck::operator()() {
@@ -0,0 +1,146 @@
+#include "incremental_scanner.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+/*
+ * Applies random edits to random sources and compares the tokens and line positions of the IncrementalScanner after every edit with the
+ * ones of a Scanner over the whole source. The alphabet favours the bytes that start or end comments, operators and line feeds, so edits
+ * split and join them often. Usage: incremental_scanner_test [SOURCES] [SEED]
+ */
+
+const char ALPHABET[] = "ab1 :*=:*\n\r\n;<>()!&&\t9z\x80\xc3\xa4";
+const std::size_t MAX_SOURCE_SIZE = 160, MAX_EDIT_SIZE = 8, EDITS_PER_SOURCE = 20;
+
+std::uint64_t random_state;
+
+std::size_t random_below(std::size_t bound) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state % bound;
+}
+
+String random_bytes(std::size_t size) {
+	String bytes;
+	for (std::size_t index = 0; index < size; index++) bytes += ALPHABET[random_below(sizeof(ALPHABET) - 1)];
+	return bytes;
+}
+
+void print_escaped(const char* name, const String& bytes) {
+	std::printf("%s: \"", name);
+	for (String::const_iterator byte = bytes.cbegin(); byte != bytes.cend(); ++byte) {
+		unsigned char symbol = static_cast<unsigned char>(*byte);
+		if (symbol >= 0x20 && symbol < 0x7f && symbol != '"' && symbol != '\\') std::putchar(symbol);
+		else std::printf("\\x%02x", symbol);
+	}
+	std::printf("\"\n");
+}
+
+bool same_value(const Token& left, const Symboltable& left_symbols, const Token& right, const Symboltable& right_symbols) {
+	switch (left.get_token_type()) {
+	case TokenType::IDENTIFIER:
+	case TokenType::OUT_OF_RANGE_INTEGER:
+		return left.get_lexem(left_symbols) == right.get_lexem(right_symbols);
+	case TokenType::INTEGER:
+		return left.get_integer(left_symbols) == right.get_integer(right_symbols);
+	case TokenType::DEADBEEF:
+	case TokenType::UNSUPPORTED_CHARACTER:
+		return left.value.error_char == right.value.error_char;
+	default:
+		return true;
+	}
+}
+
+bool same_token(const Token& left, const Symboltable& left_symbols, const Token& right, const Symboltable& right_symbols) {
+	return left.get_token_type() == right.get_token_type() && left.offset == right.offset && same_value(left, left_symbols, right, right_symbols);
+}
+
+/*
+ * Compares the tokens and their positions with a full scan of the current source.
+ */
+const char* check_full_scan(IncrementalScanner* incremental) {
+	const String& source = incremental->get_source();
+	const Vector<Token>& tokens = incremental->get_tokens();
+	Scanner scanner(source.cbegin(), source.cend());
+	std::size_t index = 0;
+
+	while (true) {
+		Token token = scanner.next_token();
+
+		if (index == tokens.size() || !same_token(tokens[index], incremental->get_symboltable(), token, scanner.get_symboltable())) return "tokens differ from a full scan";
+
+		FilePosition expected = scanner.get_line_index().resolve(token.offset), actual = incremental->get_line_index().resolve(token.offset);
+		if (expected.get_line() != actual.get_line() || expected.get_column() != actual.get_column()) return "positions differ from a full scan";
+
+		index++;
+		if (token.get_token_type() == TokenType::END_OF_FILE) break;
+	}
+
+	return index == tokens.size() ? nullptr : "more tokens than a full scan";
+}
+
+/*
+ * Tokens outside the returned span must be the ones of the previous scan, those behind it moved by the size difference of the edit.
+ */
+const char* check_span(const IncrementalScanner::TokenSpan& span, const Vector<Token>& previous, const Vector<Token>& tokens, const Symboltable& symbols, long shift) {
+	if (span.begin > span.end || span.end > tokens.size() || span.replaced_end > previous.size()) return "span out of bounds";
+	if (tokens.size() - span.end != previous.size() - span.replaced_end) return "span doesn't cover the size difference";
+
+	for (std::size_t index = 0; index < span.begin; index++) {
+		if (!same_token(tokens[index], symbols, previous[index], symbols)) return "token in front of the span changed";
+	}
+
+	for (std::size_t index = span.end, old_index = span.replaced_end; index < tokens.size(); index++, old_index++) {
+		Token moved = previous[old_index];
+		moved.offset = static_cast<std::uint32_t>(moved.offset + shift);
+
+		if (!same_token(tokens[index], symbols, moved, symbols)) return "token behind the span changed";
+	}
+
+	return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+	std::size_t sources = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+	random_state = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0x9E3779B97F4A7C15;
+
+	for (std::size_t source_index = 0; source_index < sources; source_index++) {
+		String initial = random_bytes(random_below(MAX_SOURCE_SIZE));
+		IncrementalScanner incremental(initial.cbegin(), initial.cend());
+
+		const char* failure = check_full_scan(&incremental);
+		if (failure) {
+			std::printf("%s after the initial scan\n", failure);
+			print_escaped("source", initial);
+			return EXIT_FAILURE;
+		}
+
+		for (std::size_t edit = 0; edit < EDITS_PER_SOURCE; edit++) {
+			String before(incremental.get_source());
+			Vector<Token> previous(incremental.get_tokens());
+
+			std::size_t offset = random_below(before.size() + 1);
+			std::size_t removed_size = random_below(std::min(before.size() - offset, MAX_EDIT_SIZE) + 1);
+			String inserted = random_bytes(random_below(MAX_EDIT_SIZE + 1));
+
+			/* Resolving a position first makes the edit invalidate an index that is partly built. */
+			if (random_below(2) == 0 && previous.size() != 0) incremental.get_line_index().resolve(previous[random_below(previous.size())].offset);
+
+			IncrementalScanner::TokenSpan span = incremental.edit(offset, removed_size, inserted.cbegin(), inserted.size());
+
+			failure = check_full_scan(&incremental);
+			if (!failure) failure = check_span(span, previous, incremental.get_tokens(), incremental.get_symboltable(), static_cast<long>(inserted.size()) - static_cast<long>(removed_size));
+
+			if (failure) {
+				std::printf("%s after replacing %zu bytes at %zu\n", failure, removed_size, offset);
+				print_escaped("before", before);
+				print_escaped("inserted", inserted);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	std::printf("incremental scanner: %zu sources with %zu edits each agree with full scans\n", sources, EDITS_PER_SOURCE);
+	return EXIT_SUCCESS;
+}